@@ -13,16 +13,56 @@
 
 #define MAX_LEN 512
 
-int *cube;
+/* parti della funzione descritte dal file (.type), di default fd come in espresso */
+#define PLA_TYPE_F 1
+#define PLA_TYPE_D 2
+#define PLA_TYPE_R 4
+
+/**
+ * @brief OR del nodo f nel nodo *node
+ */
+static void orInto(DdManager *manager, DdNode **node, DdNode *f)
+{
+	DdNode *tmpNode = Cudd_bddOr(manager, f, *node);
+	Cudd_Ref(tmpNode);
+	Cudd_RecursiveDeref(manager, *node);
+	*node = tmpNode;
+}
+
+/**
+ * @brief legge il tipo della PLA (f, fd, fr, fdr)
+ *
+ * @param type la stringa dopo .type
+ * @return int le parti descritte dal file, -1 se il tipo non è supportato
+ */
+static int readType(const char *type)
+{
+	int t = 0;
+
+	for (const char *c = type; *c != '\0'; c++)
+	{
+		if (*c == 'f')
+			t |= PLA_TYPE_F;
+		else if (*c == 'd')
+			t |= PLA_TYPE_D;
+		else if (*c == 'r')
+			t |= PLA_TYPE_R;
+		else
+			return -1;
+	}
+	return t;
+}
 
 /**
  * @brief costruisce un nodo rappresentante un singolo prodotto
  * 
+ * @param manager il CUDD manager
  * @param input il vettore di caratteri rappresentante il prodotto
  * @param pla la struttura relativa al file
+ * @param cube il buffer in cui viene scritto il prodotto come vettore di interi
  * @return DdNode* il nodo rappresentante il prodotto
  */
-DdNode *read_product(char *input, ParsedPLA *pla)
+DdNode *read_product(DdManager *manager, char *input, ParsedPLA *pla, int *cube)
 {
 	DdNode *f;
 	DdNode *tmpNode;
@@ -58,43 +98,73 @@ DdNode *read_product(char *input, ParsedPLA *pla)
 }
 
 /**
- * @brief inserisce il nodo f all'interno della bdd
+ * @brief inserisce il nodo f all'interno della bdd. Come in espresso '1' e '4'
+ *  indicano l'On-set, '-' e '2' il DC-set, '0' e '3' l'Off-set, '~' nessuno
  * 
+ * @param manager il CUDD manager
  * @param f il nodo
  * @param output l'output legato ad f
  * @param pla la struttura del file
+ * @param dc il DC-set, NULL se non richiesto
+ * @param off l'Off-set, NULL se non richiesto
+ * @param cube il prodotto letto da read_product
  */
-void build_bdd(DdNode *f, char *output, ParsedPLA *pla, int isMinimized)
+void build_bdd(DdManager *manager, DdNode *f, char *output, ParsedPLA *pla, DdNode **dc, DdNode **off, int *cube,
+			   int isMinimized)
 {
-	DdNode *tmpNode;
+	if (isMinimized)
+		pla->in_literals += cube_literals(cube, pla->num_in);
 	for (int i = 0; i < pla->num_out; i++)
 	{
-		if (output[i] == '0') // OFF set
-			continue;
-		if (output[i] == '1')
-		{ // ON set
-			tmpNode = Cudd_bddOr(manager, f, pla->vectorbdd_F[i]);
-			Cudd_Ref(tmpNode);
-			Cudd_RecursiveDeref(manager, pla->vectorbdd_F[i]);
-			pla->vectorbdd_F[i] = tmpNode;
-
+		switch (output[i])
+		{
+		case '1':
+		case '4': // ON set
+			orInto(manager, &(pla->vectorbdd_F[i]), f);
 			if (isMinimized)
-			{
-				CubeListEntry *c = alloc_node(pla->num_in);
-				memcpy(c->cube, cube, pla->num_in * sizeof(int));
-				TAILQ_INSERT_TAIL(&(CUBE_LIST[i]), c, entries);
-				(N_CUBES[i])++;
-			}
+				cube_append(pla, i, cube);
+			break;
+		case '-':
+		case '2': // DC set
+			if (dc != NULL)
+				orInto(manager, &(dc[i]), f);
+			break;
+		case '0':
+		case '3': // OFF set
+			if (off != NULL)
+				orInto(manager, &(off[i]), f);
+			break;
 		}
 	}
 
 	Cudd_RecursiveDeref(manager, f);
 }
 
-int parse(char *inputfile, int init_manager, ParsedPLA *pla, int isMinimized)
+/**
+ * @brief alloca un vettore di num_out BDD vuote
+ */
+static DdNode **emptyVector(DdManager *manager, int num_out)
+{
+	DdNode **v = safe_malloc(num_out * sizeof(DdNode *));
+
+	for (int i = 0; i < num_out; i++)
+	{
+		v[i] = Cudd_ReadLogicZero(manager);
+		Cudd_Ref(v[i]);
+	}
+	return v;
+}
+
+int parse(char *inputfile, DdManager **manager, ParsedPLA *pla, ParsedPLA *dc, int isMinimized)
+{
+	return parse_outputs(inputfile, manager, pla, dc, isMinimized, 0, -1);
+}
+
+int parse_outputs(char *inputfile, DdManager **manager, ParsedPLA *pla, ParsedPLA *dc, int isMinimized, int first, int n)
 {
 	char tmp[MAX_LEN];
-	int done = 0;
+	int done = 0, file_out = 0;
+	int type = PLA_TYPE_F | PLA_TYPE_D;
 	DdNode *f;
 	FILE *PLAFile;
 	PLAFile = fopen(inputfile, "r");
@@ -105,72 +175,128 @@ int parse(char *inputfile, int init_manager, ParsedPLA *pla, int isMinimized)
 	}
 	while (!done && fscanf(PLAFile, "%s\n", tmp) != EOF)
 	{
-		if (tmp[0] == '.')
+		if (strcmp(tmp, ".type") == 0)
+		{
+			fscanf(PLAFile, "%s", tmp);
+			if ((type = readType(tmp)) == -1)
+			{
+				fprintf(stderr, "Unsupported PLA type %s\n", tmp);
+				fclose(PLAFile);
+				return -1;
+			}
+		}
+		else if ((tmp[0] == '.') && (tmp[2] == '\0'))
 		{
 			switch (tmp[1])
 			{
 			case 'i':
 			{
 				fscanf(PLAFile, "%d\n", &(pla->num_in));
-				if (init_manager)
-					manager = Cudd_Init(pla->num_in, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+				if (*manager == NULL)
+					*manager = Cudd_Init(pla->num_in, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
 			}
 			break;
 			case 'o':
 			{
-				int i;
-
-				fscanf(PLAFile, "%d\n", &(pla->num_out));
-				pla->vectorbdd_F = (DdNode **)calloc(pla->num_out, sizeof(DdNode *));
-				if (pla->vectorbdd_F == NULL)
-				{
-					fprintf(stderr, "INPUT vectorbdd_F: Error in calloc\n");
-					Cudd_Quit(manager);
-					fclose(PLAFile);
-					return -1;
-				}
-				for (i = 0; i < pla->num_out; i++)
-				{
-					pla->vectorbdd_F[i] = Cudd_ReadLogicZero(manager);
-					Cudd_Ref(pla->vectorbdd_F[i]);
-				}
+				fscanf(PLAFile, "%d\n", &file_out);
 				done = 1;
 			}
 			break;
 			}
 		}
 	}
-	if (pla->num_in <= 0 || pla->num_out <= 0)
+	if (pla->num_in <= 0 || file_out <= 0 || first < 0 || (n > 0 && first + n > file_out))
 	{
 		fclose(PLAFile);
 		return -1;
 	}
 
+	/* solo intestazione */
+	pla->num_out = (n > 0) ? n : file_out;
+	if (n == 0)
+	{
+		fclose(PLAFile);
+		return 1;
+	}
+
+	pla->vectorbdd_F = (DdNode **)calloc(pla->num_out, sizeof(DdNode *));
+	if (pla->vectorbdd_F == NULL)
+	{
+		fprintf(stderr, "INPUT vectorbdd_F: Error in calloc\n");
+		fclose(PLAFile);
+		return -1;
+	}
+	for (int i = 0; i < pla->num_out; i++)
+	{
+		pla->vectorbdd_F[i] = Cudd_ReadLogicZero(*manager);
+		Cudd_Ref(pla->vectorbdd_F[i]);
+	}
+
 	int readInput = 1;
 	int readOutput = 0;
 	int inputreaded = 0;
 	int outputreaded = 0;
 	char delimit[] = "|";
 	char *input = (char *)calloc(pla->num_in + 1, sizeof(char));
-	char *output = (char *)calloc(pla->num_out + 1, sizeof(char));
+	char *output = (char *)calloc(file_out + 1, sizeof(char));
 
-	cube = safe_malloc(pla->num_in * sizeof(int));
+	int *cube = safe_malloc(pla->num_in * sizeof(int));
 	if (isMinimized)
 		initParsedPLA(pla);
 
+	/* DC-set e, per le PLA di tipo fr, Off-set da cui ricavarlo */
+	DdNode **off = NULL;
+	if (dc != NULL)
+	{
+		dc->num_in = pla->num_in;
+		dc->num_out = pla->num_out;
+		dc->vectorbdd_F = emptyVector(*manager, pla->num_out);
+	}
+
 	while (fscanf(PLAFile, "%s", tmp) > 0)
 	{
+		if (readInput && ((tmp[0] == '.') || (tmp[0] == '#')))
+		{
+			if (strcmp(tmp, ".type") == 0)
+			{
+				if ((fscanf(PLAFile, "%s", tmp) != 1) || ((type = readType(tmp)) == -1))
+				{
+					/* come nell'intestazione: i vettori di pla e dc vengono rilasciati dal chiamante */
+					fprintf(stderr, "Unsupported PLA type %s\n", tmp);
+					if (off != NULL)
+					{
+						for (int i = 0; i < pla->num_out; i++)
+							Cudd_RecursiveDeref(*manager, off[i]);
+						free(off);
+					}
+					free(input);
+					free(output);
+					free(cube);
+					fclose(PLAFile);
+					return -1;
+				}
+			}
+			else if ((strcmp(tmp, ".e") == 0) || (strcmp(tmp, ".end") == 0))
+				break;
+			else /* direttive non rilevanti (.p, .ilb, .ob, ...) e commenti */
+				fgets(tmp, MAX_LEN, PLAFile);
+			continue;
+		}
 
-		if (strlen(tmp) > pla->num_in + pla->num_out)
+		if ((dc != NULL) && (off == NULL) && ((type & (PLA_TYPE_D | PLA_TYPE_R)) == PLA_TYPE_R))
+			off = emptyVector(*manager, pla->num_out);
+
+		if (strlen(tmp) > pla->num_in + file_out)
 		{
 			char *tmpstr;
 			char *p1 = strtok_r(tmp, delimit, &tmpstr);
 			strcpy(input, p1);
 			char *p2 = strtok_r(NULL, "\n", &tmpstr);
 			strcpy(output, p2);
-			f = read_product(input, pla);
+			f = read_product(*manager, input, pla, cube);
 			Cudd_Ref(f);
-			build_bdd(f, output, pla, isMinimized);
+			build_bdd(*manager, f, output + first, pla, ((dc != NULL) && (type & PLA_TYPE_D)) ? dc->vectorbdd_F : NULL, off,
+					  cube, isMinimized);
 			readInput = 0;
 			readOutput = 0;
 		}
@@ -187,7 +313,7 @@ int parse(char *inputfile, int init_manager, ParsedPLA *pla, int isMinimized)
 				readInput = 0;
 				readOutput = 1;
 				inputreaded = 0;
-				f = read_product(input, pla); // reads the product in PLA
+				f = read_product(*manager, input, pla, cube); // reads the product in PLA
 				Cudd_Ref(f);
 				input[0] = '\0';
 			}
@@ -195,7 +321,7 @@ int parse(char *inputfile, int init_manager, ParsedPLA *pla, int isMinimized)
 		else if (readOutput)
 		{
 			outputreaded += strlen(tmp);
-			if (outputreaded < pla->num_out)
+			if (outputreaded < file_out)
 			{ // output on multiple lines
 				output = strcat(output, tmp);
 			}
@@ -205,12 +331,27 @@ int parse(char *inputfile, int init_manager, ParsedPLA *pla, int isMinimized)
 				readInput = 1;
 				readOutput = 0;
 				outputreaded = 0;
-				build_bdd(f, output, pla, isMinimized); // inserts the product in BDD
+				build_bdd(*manager, f, output + first, pla, ((dc != NULL) && (type & PLA_TYPE_D)) ? dc->vectorbdd_F : NULL, off,
+						  cube, isMinimized); // inserts the product in BDD
 				output[0] = '\0';
 			}
 		}
 	}
 
+	/* tipo fr: il DC-set è il complemento di On-set e Off-set */
+	if (off != NULL)
+	{
+		for (int i = 0; i < pla->num_out; i++)
+		{
+			DdNode *care = Cudd_bddOr(*manager, pla->vectorbdd_F[i], off[i]);
+			Cudd_Ref(care);
+			Cudd_RecursiveDeref(*manager, dc->vectorbdd_F[i]);
+			dc->vectorbdd_F[i] = Cudd_Not(care);
+			Cudd_RecursiveDeref(*manager, off[i]);
+		}
+		free(off);
+	}
+
 	free(input);
 	free(output);
 	free(cube);
@@ -15,13 +15,32 @@
 #include "libpla.h"
 
 /**
- * @brief legge il file .pla e costruisce la bdd relativa
+ * @brief legge il file .pla e costruisce la bdd relativa. Sono supportati i tipi
+ *  f, fd (default), fr e fdr
  * @param inputfile .pla file
- * @param init_manager se 1 il cudd manager deve essere inizializzato
- * @param bdd la bdd risultante
+ * @param manager il cudd manager, se *manager è NULL viene inizializzato
+ * @param bdd la bdd risultante (On-set)
+ * @param dc il DC-set risultante, NULL se non richiesto: vuoto per il tipo f,
+ *  complemento di On-set e Off-set per il tipo fr
  * @param isMinimized se deve essere costruito il vettore di liste di prodotti
  * @return -1 in caso di errore, 1 altrimenti
  */
-int parse(char *inputfile, int init_manager, ParsedPLA *bdd, int isMinimized);
+int parse(char *inputfile, DdManager **manager, ParsedPLA *bdd, ParsedPLA *dc, int isMinimized);
+
+/**
+ * @brief come parse, limitatamente agli output [first, first + n): le strutture
+ *  risultanti hanno n output. Con n == 0 viene letta solo l'intestazione (num_in e
+ *  num_out del file), con n < 0 tutti gli output
+ * @param inputfile .pla file
+ * @param manager il cudd manager, se *manager è NULL viene inizializzato
+ * @param bdd la bdd risultante (On-set)
+ * @param dc il DC-set risultante, NULL se non richiesto
+ * @param isMinimized se deve essere costruito il vettore di liste di prodotti
+ * @param first il primo output
+ * @param n il numero di output
+ * @return -1 in caso di errore, 1 altrimenti
+ */
+int parse_outputs(char *inputfile, DdManager **manager, ParsedPLA *bdd, ParsedPLA *dc, int isMinimized, int first,
+				  int n);
 
 #endif
\ No newline at end of file
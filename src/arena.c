@@ -0,0 +1,106 @@
+/**
+ * @file arena.c
+ * @author Marco Costa
+ * @brief Implementazione dell'allocatore a regioni
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "utils.h"
+
+#define ARENA_ALIGN 16
+#define ALIGN_UP(n) (((n) + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1))
+
+struct ArenaChunk
+{
+    ArenaChunk *next;
+    size_t size; /* byte disponibili dopo l'intestazione */
+    size_t used; /* byte già allocati */
+};
+
+#define CHUNK_HDR ALIGN_UP(sizeof(ArenaChunk))
+
+static ArenaChunk *newChunk(size_t size)
+{
+    ArenaChunk *c = safe_malloc(CHUNK_HDR + size);
+    c->size = size;
+    c->used = 0;
+    return c;
+}
+
+void arena_init(Arena *a, size_t chunk_size)
+{
+    a->head = NULL;
+    a->chunk_size = (chunk_size > 0) ? ALIGN_UP(chunk_size) : ARENA_CHUNK_SIZE;
+}
+
+void *arena_alloc(Arena *a, size_t n)
+{
+    ArenaChunk *c = a->head;
+
+    n = ALIGN_UP(n);
+    if ((c == NULL) || (c->size - c->used < n))
+    {
+        if (n > a->chunk_size / 4)
+        {
+            /* le allocazioni grandi hanno un blocco dedicato, il blocco corrente resta in testa */
+            ArenaChunk *big = newChunk(n);
+            big->used = n;
+            if (c == NULL)
+            {
+                big->next = NULL;
+                a->head = big;
+            }
+            else
+            {
+                big->next = c->next;
+                c->next = big;
+            }
+            return (char *)big + CHUNK_HDR;
+        }
+
+        c = newChunk(a->chunk_size);
+        c->next = a->head;
+        a->head = c;
+    }
+
+    void *p = (char *)c + CHUNK_HDR + c->used;
+    c->used += n;
+    return p;
+}
+
+void arena_merge(Arena *dst, Arena *src)
+{
+    ArenaChunk *last = src->head;
+
+    if (last == NULL)
+        return;
+    if (dst->head == NULL)
+    {
+        dst->head = src->head;
+        src->head = NULL;
+        return;
+    }
+
+    /* i blocchi di src seguono il blocco corrente di dst, che resta in testa */
+    while (last->next != NULL)
+        last = last->next;
+    last->next = dst->head->next;
+    dst->head->next = src->head;
+    src->head = NULL;
+}
+
+void arena_free(Arena *a)
+{
+    ArenaChunk *c = a->head;
+
+    while (c != NULL)
+    {
+        ArenaChunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    a->head = NULL;
+}
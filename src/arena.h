@@ -0,0 +1,61 @@
+#ifndef _ARENA_H
+#define _ARENA_H
+
+/**
+ * @file arena.h
+ * @author Marco Costa
+ * @brief Allocatore a regioni: le allocazioni non vengono liberate singolarmente
+ *  ma tutte insieme al rilascio dell'arena
+ */
+
+#include <stddef.h>
+
+/* dimensione di default di un blocco */
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+typedef struct ArenaChunk ArenaChunk;
+
+/**
+ * @brief Arena formata da una lista di blocchi, il primo è quello in uso
+ */
+typedef struct Arena
+{
+    ArenaChunk *head;  /**< blocco corrente */
+    size_t chunk_size; /**< dimensione dei nuovi blocchi */
+} Arena;
+
+/**
+ * @brief Inizializzazione di un'arena vuota
+ *
+ * @param a l'arena
+ * @param chunk_size la dimensione dei blocchi, 0 per ARENA_CHUNK_SIZE
+ */
+void arena_init(Arena *a, size_t chunk_size);
+
+/**
+ * @brief Allocazione di n byte allineati a 16
+ *
+ * @param a l'arena
+ * @param n il numero di byte
+ * @return void* la memoria allocata, valida fino ad arena_free
+ */
+void *arena_alloc(Arena *a, size_t n);
+
+/**
+ * @brief Trasferimento dei blocchi di src in dst, per esempio da un'arena usata da un
+ *  solo thread: le allocazioni di src restano valide fino ad arena_free(dst) e src
+ *  resta vuota
+ *
+ * @param dst l'arena di destinazione
+ * @param src l'arena da svuotare
+ */
+void arena_merge(Arena *dst, Arena *src);
+
+/**
+ * @brief Rilascio di tutta la memoria dell'arena, che resta utilizzabile
+ *
+ * @param a l'arena
+ */
+void arena_free(Arena *a);
+
+#endif
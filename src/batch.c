@@ -0,0 +1,419 @@
+/**
+ * @file batch.c
+ * @author Marco Costa
+ * @brief Esecuzione di main sulle PLA di una directory per una serie di errori,
+ *  con al più n processi in parallelo. Ogni job lavora in una propria directory,
+ *  quindi i job non si sovrascrivono i file intermedi; le righe CSV vengono
+ *  stampate nell'ordine dei job (file in ordine alfabetico, poi errori nell'ordine
+ *  dato), con una riga ERROR o TIMEOUT per i job falliti
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "utils.h"
+
+/* intervallo di controllo dei processi in corso */
+#define BATCH_POLL_NS 10000000L
+
+#define CSV_HEADER "NomeFile; Ct; r [%]; oldAND ;oldOR ;newAND ;newOR ;percAND [%] ;percOR [%]; CPUtime [s]; FrontEnd"
+
+#define print_usage(name)                                                                                     \
+    fprintf(stderr, "%s [-j workers] [-t timeout-s] [-b main] [-o out-dir] pla-dir g|m error... [-- main-options]\n", \
+            name)
+
+/**
+ * @brief Stato di un job
+ */
+typedef enum
+{
+    JOB_PENDING,
+    JOB_RUNNING,
+    JOB_DONE,    /**< main terminato con successo */
+    JOB_FAILED,  /**< main terminato con errore o da un segnale */
+    JOB_TIMEOUT  /**< main terminato allo scadere del tempo */
+} JobState;
+
+/**
+ * @brief Un file PLA con un livello di errore
+ */
+typedef struct Job
+{
+    char *pla;      /**< il file PLA */
+    char *error;    /**< il livello di errore */
+    char *dir;      /**< directory di output del job, terminata da '/' */
+    pid_t pid;
+    JobState state;
+    int status;     /**< stato di uscita di waitpid */
+    double elapsed; /**< durata in secondi */
+    struct timespec start;
+} Job;
+
+/**
+ * @brief Opzioni comuni a tutti i job
+ */
+typedef struct Batch
+{
+    const char *main_bin;
+    char mode;        /**< 'g' o 'm' */
+    char **main_args; /**< opzioni aggiuntive di main */
+    int n_main_args;
+} Batch;
+
+/**
+ * @brief Secondi trascorsi da start
+ */
+static double elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int plaFilter(const struct dirent *e)
+{
+    size_t len = strlen(e->d_name);
+
+    return (len > 4) && (strcmp(e->d_name + len - 4, ".pla") == 0);
+}
+
+/**
+ * @brief Rimozione di una directory che contiene solo file
+ */
+static void removeFlatDir(const char *dir)
+{
+    DIR *d = opendir(dir);
+
+    if (d == NULL)
+        return;
+
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL)
+    {
+        if ((strcmp(e->d_name, ".") == 0) || (strcmp(e->d_name, "..") == 0))
+            continue;
+
+        char *file;
+        asprintf(&file, "%s%s", dir, e->d_name);
+        unlink(file);
+        free(file);
+    }
+    closedir(d);
+    rmdir(dir);
+}
+
+static int makeDir(const char *dir)
+{
+    if ((mkdir(dir, 0755) == -1) && (errno != EEXIST))
+    {
+        fprintf(stderr, "[!!] impossibile creare la cartella %s: ", dir);
+        perror("");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Avvio di main per un job: stdout e stderr vanno in result.csv e stderr.txt
+ *  nella directory del job, lo stato di avanzamento in progress e i file temporanei
+ *  nella sua sottodirectory tmp/
+ *
+ * @return pid_t il pid del processo, -1 in caso di errore
+ */
+static pid_t launch(Batch *b, Job *job)
+{
+    char *temp_dir, *result, *errors, *progress;
+
+    asprintf(&temp_dir, "%stmp/", job->dir);
+    asprintf(&result, "%sresult.csv", job->dir);
+    asprintf(&errors, "%sstderr.txt", job->dir);
+    asprintf(&progress, "%sprogress", job->dir);
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0)
+    {
+        free(temp_dir);
+        free(result);
+        free(errors);
+        free(progress);
+        return pid;
+    }
+
+    /* gruppo di processi proprio: allo scadere vengono terminati anche i figli di main */
+    setpgid(0, 0);
+
+    int out = open(result, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int err = open(errors, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if ((out == -1) || (err == -1) || (dup2(out, STDOUT_FILENO) == -1) || (dup2(err, STDERR_FILENO) == -1))
+        _exit(EXIT_FAILURE);
+    close(out);
+    close(err);
+
+    /* main -t -g|m errore --temp-dir ... --out-dir ... --progress ... [opzioni] file */
+    char **argv = safe_calloc(b->n_main_args + 12, sizeof(char *));
+    char mode[3] = {'-', b->mode, '\0'};
+    int argc = 0;
+
+    argv[argc++] = (char *)b->main_bin;
+    argv[argc++] = "-t";
+    argv[argc++] = mode;
+    argv[argc++] = job->error;
+    argv[argc++] = "--temp-dir";
+    argv[argc++] = temp_dir;
+    argv[argc++] = "--out-dir";
+    argv[argc++] = job->dir;
+    argv[argc++] = "--progress";
+    argv[argc++] = progress;
+    for (int i = 0; i < b->n_main_args; i++)
+        argv[argc++] = b->main_args[i];
+    argv[argc++] = job->pla;
+
+    execvp(b->main_bin, argv);
+    perror("[!!] impossibile avviare main");
+    _exit(127);
+}
+
+/**
+ * @brief Riga CSV di un job concluso: l'ultima riga stampata da main o il motivo
+ *  dell'errore
+ */
+static void printJob(Batch *b, Job *job)
+{
+    const char *name = strrchr(job->pla, '/') + 1;
+    char *last = NULL;
+
+    if (job->state == JOB_DONE)
+    {
+        char *result, *line = NULL;
+        size_t n = 0;
+
+        asprintf(&result, "%sresult.csv", job->dir);
+        FILE *f = fopen(result, "r");
+        if (f != NULL)
+        {
+            while (getline(&line, &n, f) != -1)
+            {
+                free(last);
+                last = strdup(line);
+            }
+            fclose(f);
+        }
+        free(line);
+        free(result);
+    }
+
+    if (last != NULL)
+        fputs(last, stdout);
+    else if (job->state == JOB_DONE)
+        printf("%s; -%c %s; ERROR; nessun risultato\n", name, b->mode, job->error);
+    else if (job->state == JOB_TIMEOUT)
+        printf("%s; -%c %s; TIMEOUT; %.1f s\n", name, b->mode, job->error, job->elapsed);
+    else if (WIFSIGNALED(job->status))
+        printf("%s; -%c %s; ERROR; terminato dal segnale %d\n", name, b->mode, job->error, WTERMSIG(job->status));
+    else
+        printf("%s; -%c %s; ERROR; stato di uscita %d, si veda %sstderr.txt\n", name, b->mode, job->error,
+               WEXITSTATUS(job->status), job->dir);
+    fflush(stdout);
+    free(last);
+}
+
+/**
+ * @brief Conclusione di un job: la directory temporanea viene rimossa, i file di
+ *  output restano nella directory del job
+ */
+static void finishJob(Job *job, JobState state, int status)
+{
+    char *temp_dir;
+
+    job->state = state;
+    job->status = status;
+    job->elapsed = elapsed(&(job->start));
+    job->pid = 0;
+
+    asprintf(&temp_dir, "%stmp/", job->dir);
+    removeFlatDir(temp_dir);
+    free(temp_dir);
+}
+
+int main(int argc, char *argv[])
+{
+    Batch b = {.main_bin = "./main"};
+    const char *out_dir = "./batch";
+    int opt, workers = 1;
+    double timeout = 0;
+    char *endptr;
+    long val;
+
+    /* '+': le opzioni terminano al primo argomento, le altre sono di main */
+    while ((opt = getopt(argc, argv, "+j:t:b:o:")) != -1)
+    {
+        if (opt == 'j')
+        {
+            val = strtol(optarg, &endptr, 10);
+            check_strtol(val, optarg, endptr);
+            if ((val <= 0) || (val > INT_MAX))
+            {
+                fprintf(stderr, "[!!] Il numero di worker deve essere > 0\n");
+                exit(EXIT_FAILURE);
+            }
+            workers = val;
+        }
+        else if (opt == 't')
+        {
+            timeout = strtod(optarg, &endptr);
+            if ((*endptr != '\0') || (timeout <= 0))
+            {
+                fprintf(stderr, "[!!] Il timeout deve essere > 0\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (opt == 'b')
+            b.main_bin = optarg;
+        else if (opt == 'o')
+            out_dir = optarg;
+        else
+        {
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* pla-dir g|m errore... [-- opzioni di main] */
+    int n_errors = 0;
+    while ((optind + 2 + n_errors < argc) && (strcmp(argv[optind + 2 + n_errors], "--") != 0))
+        n_errors++;
+    if ((n_errors == 0) || ((strcmp(argv[optind + 1], "g") != 0) && (strcmp(argv[optind + 1], "m") != 0)))
+    {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    const char *pla_dir = argv[optind];
+    b.mode = argv[optind + 1][0];
+    char **errors = argv + optind + 2;
+    if (optind + 2 + n_errors < argc)
+    {
+        b.main_args = argv + optind + 3 + n_errors;
+        b.n_main_args = argc - (optind + 3 + n_errors);
+    }
+
+    struct dirent **files;
+    int n_files = scandir(pla_dir, &files, plaFilter, alphasort);
+    if (n_files == -1)
+    {
+        fprintf(stderr, "[!!] impossibile leggere la cartella %s: ", pla_dir);
+        perror("");
+        exit(EXIT_FAILURE);
+    }
+    if (makeDir(out_dir) == -1)
+        exit(EXIT_FAILURE);
+
+    /* job in ordine di file, poi di errore */
+    int n_jobs = n_files * n_errors;
+    Job *jobs = safe_calloc(n_jobs > 0 ? n_jobs : 1, sizeof(Job));
+    for (int f = 0; f < n_files; f++)
+    {
+        size_t len = strlen(files[f]->d_name) - 4;
+
+        for (int e = 0; e < n_errors; e++)
+        {
+            Job *job = &(jobs[f * n_errors + e]);
+
+            asprintf(&(job->pla), "%s/%s", pla_dir, files[f]->d_name);
+            job->error = errors[e];
+            asprintf(&(job->dir), "%s/%.*s-%c%s/", out_dir, (int)len, files[f]->d_name, b.mode, errors[e]);
+        }
+        free(files[f]);
+    }
+    free(files);
+
+    puts(CSV_HEADER);
+
+    struct timespec pause = {0, BATCH_POLL_NS};
+    int next = 0, printed = 0, running = 0, failed = 0, timed_out = 0;
+
+    while (printed < n_jobs)
+    {
+        /* avvio dei job in attesa */
+        while ((running < workers) && (next < n_jobs))
+        {
+            Job *job = &(jobs[next++]);
+            char *temp_dir;
+
+            asprintf(&temp_dir, "%stmp/", job->dir);
+            clock_gettime(CLOCK_MONOTONIC, &(job->start));
+            if ((makeDir(job->dir) == -1) || (makeDir(temp_dir) == -1) || ((job->pid = launch(&b, job)) == -1))
+            {
+                perror("[!!] impossibile avviare il job");
+                finishJob(job, JOB_FAILED, EXIT_FAILURE << 8);
+            }
+            else
+            {
+                job->state = JOB_RUNNING;
+                running++;
+            }
+            free(temp_dir);
+        }
+
+        /* job conclusi e scaduti */
+        for (int i = printed; i < next; i++)
+        {
+            Job *job = &(jobs[i]);
+            int status;
+
+            if (job->state != JOB_RUNNING)
+                continue;
+
+            if (waitpid(job->pid, &status, WNOHANG) == job->pid)
+                finishJob(job, (WIFEXITED(status) && (WEXITSTATUS(status) == 0)) ? JOB_DONE : JOB_FAILED, status);
+            else if ((timeout > 0) && (elapsed(&(job->start)) >= timeout))
+            {
+                kill(-(job->pid), SIGKILL);
+                waitpid(job->pid, &status, 0);
+                finishJob(job, JOB_TIMEOUT, status);
+            }
+            else
+                continue;
+            running--;
+        }
+
+        /* le righe vengono stampate nell'ordine dei job */
+        while ((printed < next) && (jobs[printed].state != JOB_RUNNING))
+        {
+            Job *job = &(jobs[printed++]);
+
+            printJob(&b, job);
+            failed += (job->state == JOB_FAILED);
+            timed_out += (job->state == JOB_TIMEOUT);
+        }
+
+        if (running > 0)
+            nanosleep(&pause, NULL);
+    }
+
+    fprintf(stderr, "%d job, %d falliti, %d scaduti\n", n_jobs, failed, timed_out);
+
+    for (int i = 0; i < n_jobs; i++)
+    {
+        free(jobs[i].pla);
+        free(jobs[i].dir);
+    }
+    free(jobs);
+
+    return ((failed > 0) || (timed_out > 0)) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
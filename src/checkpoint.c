@@ -0,0 +1,769 @@
+/**
+ * @file checkpoint.c
+ * @author Marco Costa
+ * @brief Implementazione del salvataggio e ripristino dello stato dell'euristica
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <cudd.h>
+#include <dddmp.h>
+
+#include "checkpoint.h"
+#include "frontcache.h"
+#include "libsop.h"
+#include "libpla.h"
+#include "config.h"
+#include "utils.h"
+
+#define CKPT_MAGIC "SOPCHECKPOINT"
+#define CKPT_VERSION 4
+
+#define INCR_MAGIC "SOPBASE"
+#define INCR_VERSION 3
+
+/* codifica dei letterali di un cubo: 0, 1, 2 (assente) */
+static const char lit_chars[] = "01-";
+
+/**
+ * @brief Apertura di un file temporaneo accanto a dest
+ *
+ * @param dest il file di destinazione
+ * @param tmp il nome del file temporaneo, da liberare con free
+ * @return FILE* il file aperto in scrittura, NULL in caso di errore
+ */
+static FILE *openTemp(const char *dest, char **tmp)
+{
+    asprintf(tmp, "%s.XXXXXX", dest);
+    int fd = mkstemp(*tmp);
+    if (fd == -1)
+    {
+        free(*tmp);
+        return NULL;
+    }
+
+    FILE *f = fdopen(fd, "w");
+    if (f == NULL)
+    {
+        close(fd);
+        unlink(*tmp);
+        free(*tmp);
+    }
+    return f;
+}
+
+static void writeCube(FILE *f, int *cube, int n)
+{
+    for (int i = 0; i < n; i++)
+        fputc(lit_chars[cube[i]], f);
+    fputc('\n', f);
+}
+
+static int readCube(FILE *f, int *cube, int n)
+{
+    if (fscanf(f, " ") == EOF)
+        return -1;
+
+    for (int i = 0; i < n; i++)
+    {
+        int ch = fgetc(f);
+        char *c = ((ch == EOF) || (ch == '\0')) ? NULL : strchr(lit_chars, ch);
+
+        if (c == NULL)
+            return -1;
+        cube[i] = c - lit_chars;
+    }
+    return 0;
+}
+
+/**
+ * @brief Scrittura delle origini aggiuntive di un candidato: numero ed elenco
+ */
+static void writeOrigins(FILE *f, product_t *p)
+{
+    fprintf(f, "%d ", p->n_origins);
+    for (int k = 0; k < p->n_origins; k++)
+        fprintf(f, "%d ", p->origins[k]);
+}
+
+static int readOrigins(FILE *f, Arena *a, product_t *p)
+{
+    int n, origin;
+
+    if ((fscanf(f, "%d", &n) != 1) || (n < 0))
+        return -1;
+
+    for (int k = 0; k < n; k++)
+    {
+        if (fscanf(f, "%d", &origin) != 1)
+            return -1;
+        product_add_origin(a, p, origin);
+    }
+    return 0;
+}
+
+/**
+ * @brief Salvataggio di On-set, DC-set e Off-set in un unico file dddmp
+ */
+static int saveBdds(SopContext *ctx)
+{
+    int num_out = ctx->num_out;
+    DdNode **roots = safe_malloc(3 * num_out * sizeof(DdNode *));
+    char *dest, *tmp;
+    int ret = -1;
+
+    for (int o = 0; o < num_out; o++)
+    {
+        roots[o] = ctx->minimized.vectorbdd_F[o];
+        roots[num_out + o] = ctx->dcset.vectorbdd_F[o];
+        roots[2 * num_out + o] = ctx->offset[o];
+    }
+
+    asprintf(&dest, "%s" CHECKPOINT_BDD, ctx->ckpt.dir);
+    FILE *f = openTemp(dest, &tmp);
+    if (f != NULL)
+    {
+        if ((Dddmp_cuddBddArrayStore(ctx->manager, "sop", 3 * num_out, roots, NULL, NULL, NULL,
+                                     DDDMP_MODE_BINARY, DDDMP_VARIDS, tmp, f) == DDDMP_SUCCESS) &&
+            (fclose(f) == 0) && (rename(tmp, dest) == 0))
+            ret = 0;
+        else
+            unlink(tmp);
+        free(tmp);
+    }
+
+    free(dest);
+    free(roots);
+    return ret;
+}
+
+/**
+ * @brief Salvataggio dello stato: intestazione, errore ammesso, statistiche,
+ *  contatori, liste di prodotti e coda in ordine di inserimento
+ */
+static int saveState(SopContext *ctx, SopSearchState *st)
+{
+    int num_in = ctx->num_in, num_out = ctx->num_out;
+    ParsedPLA *pla = &(ctx->minimized);
+    prior_queue *q = st->queue;
+    struct test_stats *s = &(ctx->original_stats);
+    char *dest, *tmp;
+
+    asprintf(&dest, "%s" CHECKPOINT_STATE, ctx->ckpt.dir);
+    FILE *f = openTemp(dest, &tmp);
+    if (f == NULL)
+    {
+        free(dest);
+        return -1;
+    }
+
+    fprintf(f, CKPT_MAGIC " %d\nkey %s\nsize %d %d\n", CKPT_VERSION, ctx->ckpt.key, num_in, num_out);
+    fprintf(f, "error %d %llu %a\n", ctx->error_mode, ctx->ct, ctx->r);
+    fprintf(f, "stats %d %d %d %d\n", s->prod_in, s->prod_out, s->and_lit, s->or_port);
+    /* letterali e prodotti per output della funzione minimizzata, limite della decomposizione */
+    fprintf(f, "outputs");
+    for (int o = 0; o < num_out; o++)
+        fprintf(f, " %d %d", ctx->output_stats[o].and_lit, ctx->output_stats[o].or_port);
+    fputc('\n', f);
+    fprintf(f, "search %llu %d %d\n", st->total_error, st->added_product, st->dcset_error);
+    for (int o = 0; o < num_out; o++)
+        fprintf(f, "%llu ", st->current_errors[o]);
+    fputc('\n', f);
+
+    for (int o = 0; o < num_out; o++)
+    {
+        fprintf(f, "cubes %d\n", cube_count(pla, o));
+        for (int i = 0; i < pla->cubes[o].len; i++)
+            if (cube_alive(pla, o, i))
+                writeCube(f, cube_at(pla, o, i), num_in);
+    }
+
+    /* i candidati validi in ordine di chiave, così la ripresa estrae gli stessi prodotti */
+    int *pos = safe_malloc((q->n_data + 1) * sizeof(int));
+    int valid = 0;
+
+    for (int k = 0; k < q->n_data; k++)
+        pos[k] = -1;
+    for (int i = 0; i < q->len; i++)
+        if (queue_at(q, i)->valid)
+        {
+            pos[q->key[i]] = i;
+            valid++;
+        }
+
+    fprintf(f, "queue %d\n", valid);
+    for (int k = 0; k < q->n_data; k++)
+    {
+        if (pos[k] == -1)
+            continue;
+
+        product_t *p = queue_at(q, pos[k]);
+        fprintf(f, "%d %d %d %a %a ", p->output_f, p->product_number, p->covered_prod,
+                p->compl_min, q->prio[pos[k]]);
+        writeOrigins(f, p);
+        writeCube(f, p->cube, num_in);
+    }
+    free(pos);
+
+    int ret = -1;
+    if ((fclose(f) == 0) && (rename(tmp, dest) == 0))
+        ret = 0;
+    else
+        unlink(tmp);
+
+    free(tmp);
+    free(dest);
+    return ret;
+}
+
+int ckpt_save(SopContext *ctx, SopSearchState *st)
+{
+    SopCheckpoint *c = &(ctx->ckpt);
+
+    if (!c->bdd_saved)
+    {
+        /* uno stato precedente non deve essere associato ai nuovi BDD */
+        char *state;
+        asprintf(&state, "%s" CHECKPOINT_STATE, c->dir);
+        unlink(state);
+        free(state);
+
+        if (saveBdds(ctx) == -1)
+            goto error;
+        c->bdd_saved = 1;
+    }
+
+    if (saveState(ctx, st) == 0)
+        return 0;
+
+error:
+    fprintf(stderr, "[!!] impossibile salvare il checkpoint in %s\n", c->dir);
+    return -1;
+}
+
+/**
+ * @brief Caricamento dei BDD salvati da saveBdds
+ */
+static int loadBdds(SopContext *ctx, const char *dir)
+{
+    int num_out = ctx->num_out;
+    DdNode **roots = NULL;
+    char *fname;
+
+    asprintf(&fname, "%s" CHECKPOINT_BDD, dir);
+    int n = Dddmp_cuddBddArrayLoad(ctx->manager, DDDMP_ROOT_MATCHLIST, NULL, DDDMP_VAR_MATCHIDS, NULL, NULL, NULL,
+                                   DDDMP_MODE_BINARY, fname, NULL, &roots);
+    free(fname);
+
+    if (n != 3 * num_out)
+    {
+        for (int i = 0; i < n; i++)
+            Cudd_RecursiveDeref(ctx->manager, roots[i]);
+        free(roots);
+        return -1;
+    }
+
+    ctx->minimized.num_in = ctx->dcset.num_in = ctx->num_in;
+    ctx->minimized.num_out = ctx->dcset.num_out = num_out;
+    ctx->minimized.vectorbdd_F = safe_malloc(num_out * sizeof(DdNode *));
+    ctx->dcset.vectorbdd_F = safe_malloc(num_out * sizeof(DdNode *));
+    ctx->offset = safe_malloc(num_out * sizeof(DdNode *));
+    memcpy(ctx->minimized.vectorbdd_F, roots, num_out * sizeof(DdNode *));
+    memcpy(ctx->dcset.vectorbdd_F, roots + num_out, num_out * sizeof(DdNode *));
+    memcpy(ctx->offset, roots + 2 * num_out, num_out * sizeof(DdNode *));
+
+    free(roots);
+    return 0;
+}
+
+/**
+ * @brief Caricamento dello stato salvato da saveState
+ */
+static int loadState(SopContext *ctx, FILE *f, SopSearchState *st)
+{
+    int num_in = ctx->num_in, num_out = ctx->num_out;
+    ParsedPLA *pla = &(ctx->minimized);
+    struct test_stats *s = &(ctx->original_stats);
+    int mode, read = -1;
+
+    if (fscanf(f, " error %d %llu %la", &mode, &(ctx->ct), &(ctx->r)) != 3 ||
+        fscanf(f, " stats %d %d %d %d", &(s->prod_in), &(s->prod_out), &(s->and_lit), &(s->or_port)) != 4 ||
+        (fscanf(f, " outputs%n", &read) != 0) || (read == -1))
+        return -1;
+
+    free(ctx->output_stats);
+    ctx->output_stats = safe_calloc(num_out, sizeof(struct test_stats));
+    for (int o = 0; o < num_out; o++)
+        if (fscanf(f, "%d %d", &(ctx->output_stats[o].and_lit), &(ctx->output_stats[o].or_port)) != 2)
+            return -1;
+
+    if (fscanf(f, " search %llu %d %d", &(st->total_error), &(st->added_product), &(st->dcset_error)) != 3)
+        return -1;
+
+    ctx->error_mode = (mode == GLOBAL_OUTPUT_ERROR) ? GLOBAL_OUTPUT_ERROR : MULTIPLE_OUTPUT_ERROR;
+    ctx->ct_percent = 0;
+
+    st->current_errors = safe_calloc(num_out, sizeof(unsigned long long));
+    for (int o = 0; o < num_out; o++)
+        if (fscanf(f, "%llu", &(st->current_errors[o])) != 1)
+            return -1;
+
+    initParsedPLA(pla);
+
+    int cube[num_in];
+    for (int o = 0; o < num_out; o++)
+    {
+        int n;
+
+        if (fscanf(f, " cubes %d", &n) != 1)
+            return -1;
+        for (int i = 0; i < n; i++)
+        {
+            if (readCube(f, cube, num_in) == -1)
+                return -1;
+            cube_append(pla, o, cube);
+        }
+    }
+
+    int len;
+    if (fscanf(f, " queue %d", &len) != 1)
+        return -1;
+
+    st->queue = safe_malloc(sizeof(prior_queue));
+    queue_init(st->queue, len);
+    for (int i = 0; i < len; i++)
+    {
+        product_t *p = product_new(&(ctx->candidates), num_in);
+        double priority;
+
+        p->valid = 1;
+        p->epoch = -1; /* i contatori delle accettazioni ripartono da zero */
+        append(st->queue, 0, p);
+        if ((fscanf(f, "%d %d %d %la %la", &(p->output_f), &(p->product_number), &(p->covered_prod),
+                    &(p->compl_min), &priority) != 5) ||
+            (p->output_f < 0) || (p->output_f >= num_out) || (readOrigins(f, &(ctx->candidates), p) == -1) ||
+            (readCube(f, p->cube, num_in) == -1))
+            return -1;
+        st->queue->prio[st->queue->len - 1] = priority;
+    }
+    heapify(st->queue);
+
+    return 0;
+}
+
+int ckpt_load(SopContext *ctx, const char *dir, const char *inputfile)
+{
+    char key[FCACHE_KEY_LEN], saved_key[FCACHE_KEY_LEN];
+    char *fname;
+    int version;
+
+    asprintf(&fname, "%s" CHECKPOINT_STATE, dir);
+    FILE *f = fopen(fname, "r");
+    free(fname);
+    if (f == NULL)
+    {
+        fprintf(stderr, "[!!] impossibile aprire il checkpoint in %s : ", dir);
+        perror("");
+        return -1;
+    }
+
+    if ((fscanf(f, CKPT_MAGIC " %d key %63s size %d %d", &version, saved_key, &(ctx->num_in), &(ctx->num_out)) != 4) ||
+        (version != CKPT_VERSION) || (ctx->num_in <= 0) || (ctx->num_out <= 0))
+    {
+        fprintf(stderr, "[!!] checkpoint in %s non valido\n", dir);
+        fclose(f);
+        return -1;
+    }
+
+    if ((fcache_key(inputfile, key) == -1) || (strcmp(key, saved_key) != 0))
+    {
+        fprintf(stderr, "[!!] il checkpoint in %s non è stato generato da %s\n", dir, inputfile);
+        fclose(f);
+        return -1;
+    }
+    strcpy(ctx->ckpt.key, key);
+
+    /* tutte le variabili devono esistere anche se non compaiono nei BDD */
+    for (int i = 0; i < ctx->num_in; i++)
+        Cudd_bddIthVar(ctx->manager, i);
+
+    SopSearchState *st = safe_calloc(1, sizeof(SopSearchState));
+    int ret = loadBdds(ctx, dir);
+
+    if (ret == -1)
+        fprintf(stderr, "[!!] impossibile caricare i BDD del checkpoint in %s\n", dir);
+    else if ((ret = loadState(ctx, f, st)) == -1)
+        fprintf(stderr, "[!!] checkpoint in %s non valido\n", dir);
+
+    fclose(f);
+    ctx->ckpt.resumed = st;
+    if (ret == -1)
+        ckpt_discard(ctx);
+
+    return ret;
+}
+
+void ckpt_discard(SopContext *ctx)
+{
+    SopSearchState *st = ctx->ckpt.resumed;
+
+    if (st == NULL)
+        return;
+
+    /* i candidati sono nell'arena del contesto */
+    if (st->queue != NULL)
+    {
+        queue_free(st->queue);
+        free(st->queue);
+    }
+
+    free(st->current_errors);
+    free(st);
+    ctx->ckpt.resumed = NULL;
+}
+
+/**
+ * @brief Rilascio dei dati di un output della base precedente
+ */
+static void freeIncrOutput(IncrOutput *p)
+{
+    /* i candidati sono nell'arena del contesto */
+    free(p->cand);
+    free(p->prio);
+    free(p->res);
+}
+
+static int compareInt(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+/**
+ * @brief Origini di un candidato riportate alle posizioni dei prodotti nella funzione
+ *  appena letta: la minore diventa product_number, le altre restano in ordine crescente
+ *
+ * @param c il candidato
+ * @param map la posizione attuale di ogni prodotto della base
+ * @param n il numero di prodotti
+ * @return int -1 se un'origine non è un prodotto della base, 0 altrimenti
+ */
+static int remapOrigins(product_t *c, const int *map, int n)
+{
+    if ((c->product_number < 0) || (c->product_number >= n))
+        return -1;
+    c->product_number = map[c->product_number];
+
+    for (int k = 0; k < c->n_origins; k++)
+    {
+        if ((c->origins[k] < 0) || (c->origins[k] >= n))
+            return -1;
+        c->origins[k] = map[c->origins[k]];
+        if (c->origins[k] < c->product_number)
+        {
+            int tmp = c->product_number;
+            c->product_number = c->origins[k];
+            c->origins[k] = tmp;
+        }
+    }
+    qsort(c->origins, c->n_origins, sizeof(int), compareInt);
+    return 0;
+}
+
+/**
+ * @brief Lettura di un output della base precedente e confronto con l'output o
+ *  della funzione appena letta. I prodotti sono confrontati come insieme: se
+ *  l'ordine è cambiato le origini dei candidati vengono rinumerate
+ */
+static int loadIncrOutput(SopContext *ctx, FILE *f, int o, DdNode *dc, IncrOutput *p)
+{
+    ParsedPLA *pla = &(ctx->minimized);
+    int num_in = ctx->num_in, len = pla->cubes[o].len;
+    int idx, n, ret = -1, cube[num_in];
+    int *map = NULL;
+    PlaRows rows;
+
+    if ((fscanf(f, " output %d %llu %d cubes %d", &idx, &(p->error), &(p->dc_error), &n) != 4) || (idx != o))
+        return -1;
+
+    /* subito dopo il parsing non ci sono tombstone; un prodotto ripetuto nella
+       funzione appena letta non permette una corrispondenza univoca */
+    pla_rows_init(&rows, num_in, 1);
+    p->reuse = (dc == ctx->dcset.vectorbdd_F[o]) && (n == len);
+    if (p->reuse)
+    {
+        map = safe_malloc(n * sizeof(int));
+        for (int i = 0; i < len; i++)
+            pla_rows_index(&rows, cube_at(pla, o, i), 0);
+        p->reuse = (rows.len == len);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        if (readCube(f, cube, num_in) == -1)
+            goto end;
+        if (!p->reuse)
+            continue;
+
+        /* un prodotto assente viene aggiunto dopo quelli della funzione, outs segna quelli già associati */
+        int j = pla_rows_index(&rows, cube, 1);
+        if ((j >= len) || (rows.outs[j] == '1'))
+            p->reuse = 0;
+        else
+        {
+            rows.outs[j] = '1';
+            map[i] = j;
+        }
+    }
+
+    if (fscanf(f, " cands %d", &n) != 1)
+        goto end;
+    p->cand = safe_calloc(n, sizeof(product_t *));
+    p->prio = safe_malloc(n * sizeof(double));
+    p->n_cand = n;
+    for (int i = 0; i < n; i++)
+    {
+        product_t *c = product_new(&(ctx->candidates), num_in);
+
+        c->output_f = o;
+        c->valid = 1;
+        p->cand[i] = c;
+        if ((fscanf(f, "%d %d %la %la", &(c->product_number), &(c->covered_prod), &(c->compl_min), &(p->prio[i])) != 4) ||
+            (readOrigins(f, &(ctx->candidates), c) == -1) || (readCube(f, c->cube, num_in) == -1) ||
+            (p->reuse && (remapOrigins(c, map, len) == -1)))
+            goto end;
+    }
+
+    if (fscanf(f, " result %d", &(p->n_res)) != 1)
+        goto end;
+    p->res = safe_malloc((size_t)(p->n_res + 1) * num_in * sizeof(int));
+    for (int i = 0; i < p->n_res; i++)
+        if (readCube(f, p->res + (size_t)i * num_in, num_in) == -1)
+            goto end;
+
+    /* i dati di un output non riutilizzabile non servono */
+    if (!p->reuse)
+    {
+        freeIncrOutput(p);
+        memset(p, 0, sizeof(IncrOutput));
+    }
+    ret = 0;
+
+end:
+    pla_rows_free(&rows);
+    free(map);
+    return ret;
+}
+
+int incr_load(SopContext *ctx)
+{
+    SopIncremental *in = &(ctx->incr);
+    int num_out = ctx->num_out;
+    int version, b_in, b_out, mode, lazy, beam_width, beam_depth, n = 0, reused = 0;
+    unsigned long long ct;
+    DdNode **roots = NULL;
+    char *fname;
+
+    asprintf(&fname, "%s" INCR_BASE, in->base_dir);
+    FILE *f = fopen(fname, "r");
+    free(fname);
+    if (f == NULL)
+    {
+        fprintf(stderr, "[!!] nessuna base incrementale in %s, sintesi completa\n", in->base_dir);
+        return -1;
+    }
+
+    if ((fscanf(f, INCR_MAGIC " %d size %d %d error %d %llu %d beam %d %d", &version, &b_in, &b_out, &mode, &ct, &lazy,
+                &beam_width, &beam_depth) != 8) ||
+        (version != INCR_VERSION))
+        goto invalid;
+
+    if ((b_in != ctx->num_in) || (b_out != num_out) || (mode != ctx->error_mode) || (ct != ctx->ct) ||
+        (lazy != ctx->lazy) || (beam_width != ctx->beam_width) || (beam_depth != ctx->beam_depth))
+    {
+        if (ctx->output_mode == VERBOSE_LOG)
+            printf("Base incrementale con dimensioni o parametri diversi, sintesi completa\n");
+        fclose(f);
+        return -1;
+    }
+
+    asprintf(&fname, "%s" INCR_BDD, in->base_dir);
+    n = Dddmp_cuddBddArrayLoad(ctx->manager, DDDMP_ROOT_MATCHLIST, NULL, DDDMP_VAR_MATCHIDS, NULL, NULL, NULL,
+                               DDDMP_MODE_BINARY, fname, NULL, &roots);
+    free(fname);
+    if (n != num_out)
+        goto invalid;
+
+    in->prev = safe_calloc(num_out, sizeof(IncrOutput));
+    for (int o = 0; o < num_out; o++)
+    {
+        if (loadIncrOutput(ctx, f, o, roots[o], &(in->prev[o])) == -1)
+            goto invalid;
+        reused += in->prev[o].reuse;
+    }
+
+    for (int i = 0; i < n; i++)
+        Cudd_RecursiveDeref(ctx->manager, roots[i]);
+    free(roots);
+    fclose(f);
+    return reused;
+
+invalid:
+    fprintf(stderr, "[!!] base incrementale in %s non valida, sintesi completa\n", in->base_dir);
+    for (int i = 0; i < n; i++)
+        Cudd_RecursiveDeref(ctx->manager, roots[i]);
+    free(roots);
+    fclose(f);
+    if (in->prev != NULL)
+    {
+        for (int o = 0; o < num_out; o++)
+            freeIncrOutput(&(in->prev[o]));
+        free(in->prev);
+        in->prev = NULL;
+    }
+    return -1;
+}
+
+/**
+ * @brief Scrittura di un candidato
+ */
+static void writeCandidate(FILE *f, product_t *p, double priority, int num_in)
+{
+    fprintf(f, "%d %d %a %a ", p->product_number, p->covered_prod, p->compl_min, priority);
+    writeOrigins(f, p);
+    writeCube(f, p->cube, num_in);
+}
+
+void incr_capture(SopContext *ctx, prior_queue *queue)
+{
+    SopIncremental *in = &(ctx->incr);
+    ParsedPLA *pla = &(ctx->minimized);
+    int num_in = ctx->num_in, num_out = ctx->num_out;
+    int k = 0;
+
+    in->text = safe_calloc(num_out, sizeof(char *));
+    in->dc_error = safe_calloc(num_out, sizeof(int));
+
+    /* le chiavi della coda seguono l'ordine di generazione, quindi degli output */
+    for (int o = 0; o < num_out; o++)
+    {
+        IncrOutput *p = (in->prev != NULL) ? &(in->prev[o]) : NULL;
+        size_t size;
+        FILE *m = open_memstream(&(in->text[o]), &size);
+
+        fprintf(m, "cubes %d\n", cube_count(pla, o));
+        for (int i = 0; i < pla->cubes[o].len; i++)
+            if (cube_alive(pla, o, i))
+                writeCube(m, cube_at(pla, o, i), num_in);
+
+        if ((p != NULL) && p->reuse && (ctx->error_mode == MULTIPLE_OUTPUT_ERROR))
+        {
+            /* output riutilizzato senza generare candidati */
+            fprintf(m, "cands %d\n", p->n_cand);
+            for (int i = 0; i < p->n_cand; i++)
+                writeCandidate(m, p->cand[i], p->prio[i], num_in);
+        }
+        else
+        {
+            int first = k;
+
+            while ((k < queue->n_data) && (queue->data[k]->output_f == o))
+                k++;
+            fprintf(m, "cands %d\n", k - first);
+            for (int i = first; i < k; i++)
+            {
+                /* la posizione nell'heap non è nota, la priorità viene ricalcolata */
+                product_t *c = queue->data[i];
+                writeCandidate(m, c, (double)c->covered_prod / c->compl_min, num_in);
+            }
+        }
+        fclose(m);
+    }
+}
+
+int incr_save(SopContext *ctx, unsigned long long *current_errors)
+{
+    SopIncremental *in = &(ctx->incr);
+    ParsedPLA *pla = &(ctx->minimized);
+    int num_in = ctx->num_in, num_out = ctx->num_out;
+    char *dest, *tmp;
+    int ret = -1;
+
+    /* DC-set, per il confronto con la sintesi successiva */
+    asprintf(&dest, "%s" INCR_BDD, ctx->ckpt.dir);
+    FILE *f = openTemp(dest, &tmp);
+    if (f != NULL)
+    {
+        if ((Dddmp_cuddBddArrayStore(ctx->manager, "dc", num_out, ctx->dcset.vectorbdd_F, NULL, NULL, NULL,
+                                     DDDMP_MODE_BINARY, DDDMP_VARIDS, tmp, f) == DDDMP_SUCCESS) &&
+            (fclose(f) == 0) && (rename(tmp, dest) == 0))
+            ret = 0;
+        else
+            unlink(tmp);
+        free(tmp);
+    }
+    free(dest);
+    if (ret == -1)
+        goto error;
+
+    asprintf(&dest, "%s" INCR_BASE, ctx->ckpt.dir);
+    f = openTemp(dest, &tmp);
+    if (f == NULL)
+    {
+        free(dest);
+        goto error;
+    }
+
+    fprintf(f, INCR_MAGIC " %d\nsize %d %d\nerror %d %llu %d\nbeam %d %d\n", INCR_VERSION, num_in, num_out,
+            ctx->error_mode, ctx->ct, ctx->lazy, ctx->beam_width, ctx->beam_depth);
+    for (int o = 0; o < num_out; o++)
+    {
+        fprintf(f, "output %d %llu %d\n%s", o, current_errors[o], in->dc_error[o], in->text[o]);
+        fprintf(f, "result %d\n", cube_count(pla, o));
+        for (int i = 0; i < pla->cubes[o].len; i++)
+            if (cube_alive(pla, o, i))
+                writeCube(f, cube_at(pla, o, i), num_in);
+    }
+
+    ret = -1;
+    if ((fclose(f) == 0) && (rename(tmp, dest) == 0))
+        ret = 0;
+    else
+        unlink(tmp);
+    free(tmp);
+    free(dest);
+    if (ret == 0)
+        return 0;
+
+error:
+    fprintf(stderr, "[!!] impossibile salvare la base incrementale in %s\n", ctx->ckpt.dir);
+    return -1;
+}
+
+void incr_free(SopContext *ctx)
+{
+    SopIncremental *in = &(ctx->incr);
+
+    if (in->prev != NULL)
+    {
+        for (int o = 0; o < ctx->num_out; o++)
+            freeIncrOutput(&(in->prev[o]));
+        free(in->prev);
+        in->prev = NULL;
+    }
+
+    if (in->text != NULL)
+    {
+        for (int o = 0; o < ctx->num_out; o++)
+            free(in->text[o]);
+        free(in->text);
+        in->text = NULL;
+    }
+
+    free(in->dc_error);
+    in->dc_error = NULL;
+}
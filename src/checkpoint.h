@@ -0,0 +1,134 @@
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+/**
+ * @file checkpoint.h
+ * @author Marco Costa
+ * @brief Salvataggio e ripristino dello stato dell'euristica: BDD della funzione
+ *  (mediante dddmp), liste di prodotti, coda dei candidati e contatori di errore
+ */
+
+#include "queue.h"
+#include "frontcache.h"
+
+struct SopContext;
+
+/**
+ * @brief Stato dell'estrazione greedy dalla coda
+ */
+typedef struct SopSearchState
+{
+    prior_queue *queue;                  /**< candidati non ancora estratti */
+    unsigned long long *current_errors;  /**< errore per output */
+    unsigned long long total_error;      /**< errore totale */
+    int added_product;                   /**< prodotti accettati */
+    int dcset_error;                     /**< mintermini del DC-set coperti */
+} SopSearchState;
+
+/**
+ * @brief Configurazione dei checkpoint di un contesto
+ */
+typedef struct SopCheckpoint
+{
+    char *dir;                /**< directory dei checkpoint (terminata da '/'), NULL se disattivati */
+    int every;                /**< checkpoint ogni every prodotti accettati, 0 solo dopo la generazione */
+    int bdd_saved;            /**< se i BDD della sintesi corrente sono già stati salvati */
+    char key[FCACHE_KEY_LEN]; /**< chiave della PLA di ingresso */
+    SopSearchState *resumed;  /**< stato caricato da un checkpoint, consumato dall'euristica */
+} SopCheckpoint;
+
+/**
+ * @brief Dati di un output salvati da una sintesi precedente
+ */
+typedef struct IncrOutput
+{
+    int reuse;                /**< se prodotti, DC-set ed errore ammesso sono invariati */
+    int n_cand;               /**< candidati generati dall'output */
+    product_t **cand;         /**< candidati, nell'ordine di generazione */
+    double *prio;             /**< priorità dei candidati */
+    int n_res;                /**< prodotti dopo l'estrazione */
+    int *res;                 /**< prodotti dopo l'estrazione, consecutivi */
+    unsigned long long error; /**< errore dell'output */
+    int dc_error;             /**< mintermini del DC-set coperti dall'output */
+} IncrOutput;
+
+/**
+ * @brief Sintesi incrementale: confronto con la base salvata da una sintesi precedente
+ *  e raccolta dei dati per la base della sintesi corrente
+ */
+typedef struct SopIncremental
+{
+    char *base_dir;   /**< directory della base precedente, NULL se disattivata */
+    IncrOutput *prev; /**< base precedente, NULL se non caricata */
+    char **text;      /**< per ogni output prodotti e candidati della sintesi corrente */
+    int *dc_error;    /**< per ogni output mintermini del DC-set coperti */
+} SopIncremental;
+
+/**
+ * @brief Salvataggio di un checkpoint nella directory del contesto. I BDD, che non
+ *  cambiano durante l'euristica, vengono salvati solo la prima volta; lo stato
+ *  viene scritto in un file temporaneo e rinominato
+ *
+ * @param ctx il contesto
+ * @param st lo stato dell'estrazione
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int ckpt_save(struct SopContext *ctx, SopSearchState *st);
+
+/**
+ * @brief Caricamento di un checkpoint: ripristina le dimensioni, l'errore ammesso,
+ *  i BDD, le liste di prodotti e le statistiche della funzione minimizzata e
+ *  assegna lo stato dell'estrazione a ctx->ckpt.resumed. I prodotti in coda hanno
+ *  offset_inters a NULL
+ *
+ * @param ctx il contesto, con il manager già allocato
+ * @param dir la directory del checkpoint (terminata da '/')
+ * @param inputfile la PLA da cui è stato generato il checkpoint
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int ckpt_load(struct SopContext *ctx, const char *dir, const char *inputfile);
+
+/**
+ * @brief Caricamento della base di ctx->incr.base_dir e confronto con la funzione
+ *  appena letta: un output è riutilizzabile se i suoi prodotti, anche in ordine
+ *  diverso, e il suo DC-set coincidono e l'errore ammesso è lo stesso
+ *
+ * @param ctx il contesto, prima della generazione dei candidati
+ * @return int il numero di output riutilizzabili, -1 se la base non è utilizzabile
+ */
+int incr_load(struct SopContext *ctx);
+
+/**
+ * @brief Raccolta dei prodotti e dei candidati di ogni output dopo la generazione,
+ *  da salvare con incr_save
+ *
+ * @param ctx il contesto
+ * @param queue la coda dei candidati, non ancora estratta
+ */
+void incr_capture(struct SopContext *ctx, prior_queue *queue);
+
+/**
+ * @brief Salvataggio della base nella directory dei checkpoint al termine
+ *  dell'estrazione
+ *
+ * @param ctx il contesto
+ * @param current_errors l'errore di ogni output
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int incr_save(struct SopContext *ctx, unsigned long long *current_errors);
+
+/**
+ * @brief Rilascio dei dati della sintesi incrementale, esclusa base_dir
+ *
+ * @param ctx il contesto
+ */
+void incr_free(struct SopContext *ctx);
+
+/**
+ * @brief Rilascio di uno stato dell'estrazione non ancora consumato
+ *
+ * @param ctx il contesto
+ */
+void ckpt_discard(struct SopContext *ctx);
+
+#endif
@@ -8,29 +8,46 @@
 #ifndef _CONFIG_H
 #define _CONFIG_H
 
+/* directory di default, ogni SopContext può ridefinirle */
 #define TEMP_DIR "/tmp/pla/"
 #define OUTPUT_DIR "./out/"
 
-#define DONT_CARE_PLA TEMP_DIR "dontset.pla"
-#define MINIM_PLA TEMP_DIR "minimized.pla"
-#define OFFSET_PLA TEMP_DIR "offset.pla"
+/* cache dei risultati di espresso, condivisa tra le esecuzioni */
+#define CACHE_DIR TEMP_DIR "cache/"
 
-#define MINIMIZED_OUTPUT_PLA OUTPUT_DIR "out_minimized.pla"
-#define ESPRESSO_OUTPUT_PLA OUTPUT_DIR "out_espresso.pla"
-#define OUTPUT_PLA OUTPUT_DIR "out.pla"
+/* nomi dei file, relativi alla directory temporanea del contesto */
+#define MINIM_PLA "minimized.pla"
+#define OFFSET_PLA "offset.pla"
 
-#define BEST_OUTPUT_PLA OUTPUT_DIR "best.pla" // the best between espresso and not
+/* nomi dei file, relativi alla directory di output del contesto */
+#define MINIMIZED_OUTPUT_PLA "out_minimized.pla"
+#define ESPRESSO_OUTPUT_PLA "out_espresso.pla"
+#define OUTPUT_PLA "out.pla"
+
+#define BEST_OUTPUT_PLA "best.pla" // the best between espresso and not
 
 #define DEFAULT_CT 1
 
+/* ricerca beam dei prodotti espansi */
+#define DEFAULT_BEAM_DEPTH 2
+#define MAX_BEAM_WIDTH 1024
+
+/* checkpoint, relativi alla directory dei checkpoint */
+#define CHECKPOINT_BDD "checkpoint.dddmp"
+#define CHECKPOINT_STATE "checkpoint.state"
+#define INCR_BDD "incremental.dddmp"
+#define INCR_BASE "incremental.base"
+
 /* decomposizione */
-#define G_FILE TEMP_DIR "g_file.pla"
-#define F_FILE TEMP_DIR "f_file.pla"
+#define G_FILE "g_file.pla"
+#define F_FILE "f_file.pla"
 
-#define TEMP_H_DECOMP TEMP_DIR "temp_h_func.pla"
-#define G_TIMES_H_FILE TEMP_DIR "decomp_check.pla"
-#define OUT_H_DECOMP OUTPUT_DIR "h_func.pla"
+#define TEMP_H_DECOMP "temp_h_func.pla"
+#define G_TIMES_H_FILE "decomp_check.pla"
+#define OUT_H_DECOMP "h_func.pla"
+#define TEMP_H_OR_DECOMP "temp_h_or_func.pla"
+#define OUT_H_OR_DECOMP "h_or_func.pla"
 
-#define ORIGINAL_ONSET_PLA TEMP_DIR "original_onset.pla"
+#define ORIGINAL_ONSET_PLA "original_onset.pla"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,141 @@
+/**
+ * @file cover.c
+ * @author Marco Costa
+ * @brief Implementazione dell'estrazione di coperture irridondanti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cover.h"
+#include "utils.h"
+
+/**
+ * @brief BDD di un prodotto, referenziata
+ */
+static DdNode *cubeBdd(DdManager *manager, const int *cube, int num_in)
+{
+    DdNode *f = Cudd_ReadOne(manager);
+    Cudd_Ref(f);
+
+    for (int i = 0; i < num_in; i++)
+    {
+        if (cube[i] == 2)
+            continue;
+
+        DdNode *var = Cudd_bddIthVar(manager, i);
+        DdNode *tmp = Cudd_bddAnd(manager, f, (cube[i] == 1) ? var : Cudd_Not(var));
+        Cudd_Ref(tmp);
+        Cudd_RecursiveDeref(manager, f);
+        f = tmp;
+    }
+
+    return f;
+}
+
+/**
+ * @brief Unione di g in *f, g viene dereferenziata
+ */
+static void orInto(DdManager *manager, DdNode **f, DdNode *g)
+{
+    DdNode *tmp = Cudd_bddOr(manager, *f, g);
+    Cudd_Ref(tmp);
+    Cudd_RecursiveDeref(manager, *f);
+    Cudd_RecursiveDeref(manager, g);
+    *f = tmp;
+}
+
+int cover_isop(DdManager *manager, DdNode *lower, DdNode *upper, int num_in, CoverCubeFn fn, void *arg)
+{
+    DdNode *bdd, *zdd_I;
+    DdGen *gen;
+    int *path, n = 0;
+
+    /* le variabili ZDD 2i e 2i + 1 sono i letterali positivo e negativo della variabile i */
+    if (Cudd_ReadZddSize(manager) < 2 * Cudd_ReadSize(manager))
+        if (Cudd_zddVarsFromBddVars(manager, 2) == 0)
+            return -1;
+
+    bdd = Cudd_zddIsop(manager, lower, upper, &zdd_I);
+    if (bdd == NULL)
+        return -1;
+    Cudd_Ref(bdd);
+    Cudd_Ref(zdd_I);
+
+    int *cube = safe_malloc(num_in * sizeof(int));
+    Cudd_zddForeachPath(manager, zdd_I, gen, path)
+    {
+        /* una variabile assente dal cammino vale 0: il letterale non compare */
+        for (int i = 0; i < num_in; i++)
+            cube[i] = (path[2 * i] == 1) ? 1 : (path[2 * i + 1] == 1) ? 0 : 2;
+        fn(cube, arg);
+        n++;
+    }
+    free(cube);
+
+    Cudd_RecursiveDeref(manager, bdd);
+    Cudd_RecursiveDerefZdd(manager, zdd_I);
+
+    return n;
+}
+
+int cover_reduce(DdManager *manager, DdNode *lower, DdNode *upper, int *cubes, int n, int num_in)
+{
+    /* espansione: un letterale viene rimosso se il prodotto resta in upper */
+    for (int j = 0; j < n; j++)
+    {
+        int *cube = cubes + (size_t)j * num_in;
+
+        for (int i = 0; i < num_in; i++)
+        {
+            if (cube[i] == 2)
+                continue;
+
+            int lit = cube[i];
+            cube[i] = 2;
+            DdNode *f = cubeBdd(manager, cube, num_in);
+            if (!Cudd_bddLeq(manager, f, upper))
+                cube[i] = lit;
+            Cudd_RecursiveDeref(manager, f);
+        }
+    }
+
+    /* irridondanza: suffix[j] è l'unione dei prodotti da j in poi */
+    DdNode **suffix = safe_malloc((n + 1) * sizeof(DdNode *));
+    suffix[n] = Cudd_ReadLogicZero(manager);
+    Cudd_Ref(suffix[n]);
+    for (int j = n - 1; j >= 0; j--)
+    {
+        suffix[j] = suffix[j + 1];
+        Cudd_Ref(suffix[j]);
+        orInto(manager, &(suffix[j]), cubeBdd(manager, cubes + (size_t)j * num_in, num_in));
+    }
+
+    DdNode *kept = Cudd_ReadLogicZero(manager);
+    Cudd_Ref(kept);
+    int len = 0;
+
+    for (int j = 0; j < n; j++)
+    {
+        int *cube = cubes + (size_t)j * num_in;
+        DdNode *rest = Cudd_bddOr(manager, kept, suffix[j + 1]);
+        Cudd_Ref(rest);
+
+        if (!Cudd_bddLeq(manager, lower, rest))
+        {
+            orInto(manager, &kept, cubeBdd(manager, cube, num_in));
+            if (len != j)
+                memcpy(cubes + (size_t)len * num_in, cube, num_in * sizeof(int));
+            len++;
+        }
+        Cudd_RecursiveDeref(manager, rest);
+    }
+
+    for (int j = 0; j <= n; j++)
+        Cudd_RecursiveDeref(manager, suffix[j]);
+    free(suffix);
+    Cudd_RecursiveDeref(manager, kept);
+
+    return len;
+}
@@ -0,0 +1,53 @@
+#ifndef _COVER_H
+#define _COVER_H
+
+/**
+ * @file cover.h
+ * @author Marco Costa
+ * @brief Estrazione di coperture SOP irridondanti da BDD mediante Cudd_zddIsop,
+ *  in alternativa ai cammini disgiunti di Cudd_ForeachCube
+ */
+
+#include <cudd.h>
+
+/**
+ * @brief Funzione chiamata per ogni prodotto della copertura
+ *
+ * @param cube il prodotto (0, 1, 2 per il don't care), valido solo durante la chiamata
+ * @param arg l'argomento passato a cover_isop
+ */
+typedef void (*CoverCubeFn)(const int *cube, void *arg);
+
+/**
+ * @brief Enumerazione di una copertura irridondante di una funzione f con
+ *  lower <= f <= upper: con lower == upper la copertura è esatta, altrimenti
+ *  upper - lower viene usato come DC-set. Le variabili ZDD necessarie vengono
+ *  create alla prima chiamata sul manager
+ *
+ * @param manager il CUDD manager
+ * @param lower il limite inferiore
+ * @param upper il limite superiore
+ * @param num_in il numero di ingressi
+ * @param fn la funzione chiamata per ogni prodotto
+ * @param arg l'argomento di fn
+ * @return int il numero di prodotti, -1 in caso di errore
+ */
+int cover_isop(DdManager *manager, DdNode *lower, DdNode *upper, int num_in, CoverCubeFn fn, void *arg);
+
+/**
+ * @brief Passata limitata di espansione e irridondanza su una copertura di
+ *  lower <= f <= upper: ogni letterale di ogni prodotto viene rimosso se il prodotto
+ *  resta contenuto in upper, quindi vengono scartati, in ordine, i prodotti senza i
+ *  quali lower resta coperto. Una sola passata per fase, O(n * num_in) contenimenti
+ *
+ * @param manager il CUDD manager
+ * @param lower il limite inferiore
+ * @param upper il limite superiore
+ * @param cubes i prodotti, n vettori consecutivi di num_in interi
+ * @param n il numero di prodotti
+ * @param num_in il numero di ingressi
+ * @return int il numero di prodotti rimasti, compattati in testa a cubes
+ */
+int cover_reduce(DdManager *manager, DdNode *lower, DdNode *upper, int *cubes, int n, int num_in);
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ * @file ddstats.c
+ * @author Marco Costa
+ * @brief Implementazione del campionamento dei contatori del CUDD manager
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <cudd.h>
+
+#include "ddstats.h"
+#include "libsop.h"
+
+static const char *phase_names[N_PHASES] = {"parse", "candidates", "extraction", "redundancy", "decomposition"};
+
+/**
+ * @brief Istante corrente in millisecondi
+ */
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/**
+ * @brief Hook eseguito prima di ogni garbage collection
+ */
+static int preGCHook(DdManager *dd, const char *str, void *data)
+{
+    SopContext *ctx = Cudd_ReadApplicationHook(dd);
+    if (ctx != NULL)
+        ctx->dd_stats.gc_start = now_ms();
+    return 1;
+}
+
+/**
+ * @brief Hook eseguito dopo ogni garbage collection
+ */
+static int postGCHook(DdManager *dd, const char *str, void *data)
+{
+    SopContext *ctx = Cudd_ReadApplicationHook(dd);
+    if ((ctx != NULL) && (ctx->dd_stats.gc_start > 0))
+    {
+        ctx->dd_stats.gc_hook_time += now_ms() - ctx->dd_stats.gc_start;
+        ctx->dd_stats.gc_start = 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Lettura dei contatori correnti del manager
+ *
+ * @param ctx il contesto
+ * @param s il campione
+ */
+static void sample(SopContext *ctx, SopDdSample *s)
+{
+    DdManager *dd = ctx->manager;
+
+    s->time = now_ms() / 1000.0;
+    s->nodes = Cudd_ReadNodeCount(dd);
+    s->peak_nodes = Cudd_ReadPeakNodeCount(dd);
+    s->cache_hits = Cudd_ReadCacheHits(dd);
+    s->cache_lookups = Cudd_ReadCacheLookUps(dd);
+    s->gc = Cudd_ReadGarbageCollections(dd);
+    s->gc_time = Cudd_ReadGarbageCollectionTime(dd);
+    s->gc_hook_time = ctx->dd_stats.gc_hook_time;
+    s->reorderings = Cudd_ReadReorderings(dd);
+    s->memory = Cudd_ReadMemoryInUse(dd);
+}
+
+void ddstats_attach(SopContext *ctx)
+{
+    if (!ctx->dd_stats.enabled)
+        return;
+
+    Cudd_SetApplicationHook(ctx->manager, ctx);
+    Cudd_AddHook(ctx->manager, preGCHook, CUDD_PRE_GC_HOOK);
+    Cudd_AddHook(ctx->manager, postGCHook, CUDD_POST_GC_HOOK);
+}
+
+void ddstats_begin(SopContext *ctx, SopPhase p)
+{
+    progress_phase(&(ctx->progress), phase_names[p]);
+    if (!ctx->dd_stats.enabled)
+        return;
+
+    sample(ctx, &(ctx->dd_stats.begin[p]));
+}
+
+void ddstats_end(SopContext *ctx, SopPhase p)
+{
+    if (!ctx->dd_stats.enabled)
+        return;
+
+    SopDdSample *b = &(ctx->dd_stats.begin[p]);
+    SopDdSample *s = &(ctx->dd_stats.phase[p]);
+
+    sample(ctx, s);
+    s->time -= b->time;
+    s->cache_hits -= b->cache_hits;
+    s->cache_lookups -= b->cache_lookups;
+    s->gc -= b->gc;
+    s->gc_time -= b->gc_time;
+    s->gc_hook_time -= b->gc_hook_time;
+    s->reorderings -= b->reorderings;
+    ctx->dd_stats.sampled[p] = 1;
+}
+
+void ddstats_print_csv(SopContext *ctx, FILE *f)
+{
+    if (!ctx->dd_stats.enabled)
+        return;
+
+    for (int p = 0; p < N_PHASES; p++)
+    {
+        SopDdSample *s = &(ctx->dd_stats.phase[p]);
+
+        if (!ctx->dd_stats.sampled[p])
+        {
+            fprintf(f, "; ; ; ; ; ; ; ; ; ");
+            continue;
+        }
+        fprintf(f, "; %.3f; %ld; %lu; %.2f; %d; %ld; %.1f; %u; %zu",
+                s->time, s->nodes, s->peak_nodes,
+                (s->cache_lookups > 0) ? (s->cache_hits / s->cache_lookups) * 100 : 0.0,
+                s->gc, s->gc_time, s->gc_hook_time, s->reorderings, s->memory >> 10);
+    }
+}
+
+void ddstats_print_verbose(SopContext *ctx, FILE *f)
+{
+    if (!ctx->dd_stats.enabled)
+        return;
+
+    fprintf(f, "*********************************\nContatori CUDD per fase:\n");
+    fprintf(f, "%-14s %9s %10s %10s %7s %5s %8s %8s %6s %10s\n", "fase", "tempo[s]", "nodi",
+            "picco", "hit[%]", "gc", "gc[ms]", "hook[ms]", "reord", "mem[KB]");
+    for (int p = 0; p < N_PHASES; p++)
+    {
+        SopDdSample *s = &(ctx->dd_stats.phase[p]);
+
+        if (!ctx->dd_stats.sampled[p])
+            continue;
+        fprintf(f, "%-14s %9.3f %10ld %10lu %7.2f %5d %8ld %8.1f %6u %10zu\n", phase_names[p],
+                s->time, s->nodes, s->peak_nodes,
+                (s->cache_lookups > 0) ? (s->cache_hits / s->cache_lookups) * 100 : 0.0,
+                s->gc, s->gc_time, s->gc_hook_time, s->reorderings, s->memory >> 10);
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef _DDSTATS_H
+#define _DDSTATS_H
+
+/**
+ * @file ddstats.h
+ * @author Marco Costa
+ * @brief Campionamento dei contatori interni del CUDD manager ai confini delle
+ *  fasi della sintesi
+ */
+
+#include <stdio.h>
+#include <cudd.h>
+
+struct SopContext;
+
+/**
+ * @brief Fasi della sintesi in cui vengono campionati i contatori
+ */
+typedef enum
+{
+    PHASE_PARSE,         /**< espresso e parsing */
+    PHASE_CANDIDATES,    /**< generazione dei prodotti espansi */
+    PHASE_EXTRACTION,    /**< estrazione greedy dalla coda */
+    PHASE_REDUNDANCY,    /**< rimozione delle ridondanze */
+    PHASE_DECOMPOSITION, /**< decomposizione AND */
+    N_PHASES
+} SopPhase;
+
+/**
+ * @brief Campione dei contatori del manager. I contatori cumulativi (cache, GC,
+ *  riordinamenti, tempo) sono relativi alla fase, gli altri sono letti a fine fase
+ */
+typedef struct SopDdSample
+{
+    double time;               /**< tempo reale [s] */
+    long nodes;                /**< nodi vivi */
+    unsigned long peak_nodes;  /**< picco di nodi */
+    double cache_hits;         /**< hit della computed table */
+    double cache_lookups;      /**< accessi alla computed table */
+    int gc;                    /**< numero di garbage collection */
+    long gc_time;              /**< tempo di garbage collection secondo CUDD [ms] */
+    double gc_hook_time;       /**< tempo di garbage collection misurato dagli hook [ms] */
+    unsigned int reorderings;  /**< numero di riordinamenti */
+    size_t memory;             /**< memoria in uso [byte] */
+} SopDdSample;
+
+/**
+ * @brief Contatori di tutte le fasi di un contesto
+ */
+typedef struct SopDdStats
+{
+    int enabled;                  /**< se il campionamento è attivo */
+    double gc_hook_time;          /**< tempo di GC accumulato dagli hook [ms] */
+    double gc_start;              /**< inizio della GC in corso [ms] */
+    SopDdSample begin[N_PHASES];  /**< campioni di inizio fase */
+    SopDdSample phase[N_PHASES];  /**< valori delle fasi */
+    int sampled[N_PHASES];        /**< se la fase è stata completata */
+} SopDdStats;
+
+/**
+ * @brief Registra gli hook di garbage collection sul manager del contesto
+ *
+ * @param ctx il contesto
+ */
+void ddstats_attach(struct SopContext *ctx);
+
+/**
+ * @brief Campiona i contatori all'inizio della fase p
+ *
+ * @param ctx il contesto
+ * @param p la fase
+ */
+void ddstats_begin(struct SopContext *ctx, SopPhase p);
+
+/**
+ * @brief Campiona i contatori alla fine della fase p
+ *
+ * @param ctx il contesto
+ * @param p la fase
+ */
+void ddstats_end(struct SopContext *ctx, SopPhase p);
+
+/**
+ * @brief Stampa dei contatori come colonne CSV aggiuntive, per ogni fase:
+ *  time[s]; nodes; peak; hit[%]; gc; gc_ms; gc_hook_ms; reord; mem[KB]
+ *
+ * @param ctx il contesto
+ * @param f il file di output
+ */
+void ddstats_print_csv(struct SopContext *ctx, FILE *f);
+
+/**
+ * @brief Stampa dei contatori in forma tabellare
+ *
+ * @param ctx il contesto
+ * @param f il file di output
+ */
+void ddstats_print_verbose(struct SopContext *ctx, FILE *f);
+
+#endif
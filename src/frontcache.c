@@ -0,0 +1,133 @@
+/**
+ * @file frontcache.c
+ * @author Marco Costa
+ * @brief Implementazione della cache su disco dei risultati di espresso
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "frontcache.h"
+
+/* tipo di minimizzazione, fa parte della chiave */
+#ifdef EXACT_MINIMIZATION
+#define FCACHE_MODE "exact"
+#else
+#define FCACHE_MODE "heur"
+#endif
+
+#define MIN_SUFFIX ".min.pla"
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+int fcache_key(const char *inputfile, char *key)
+{
+    FILE *f = fopen(inputfile, "rb");
+    if (f == NULL)
+        return -1;
+
+    /* FNV-1a a 64 bit del contenuto */
+    uint64_t hash = FNV_OFFSET;
+    unsigned long size = 0;
+    unsigned char buf[BUFSIZ];
+    size_t n;
+
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            hash ^= buf[i];
+            hash *= FNV_PRIME;
+        }
+        size += n;
+    }
+
+    int err = ferror(f);
+    fclose(f);
+    if (err)
+        return -1;
+
+    snprintf(key, FCACHE_KEY_LEN, "%016llx-%lx-" FCACHE_MODE, (unsigned long long)hash, size);
+    return 0;
+}
+
+int fcache_lookup(const char *dir, const char *key, char **min_file)
+{
+    char *min;
+
+    asprintf(&min, "%s%s" MIN_SUFFIX, dir, key);
+
+    if (access(min, R_OK) == 0)
+    {
+        *min_file = min;
+        return 0;
+    }
+
+    free(min);
+    return -1;
+}
+
+/**
+ * @brief Copia di src in dest mediante file temporaneo e rename atomica
+ *
+ * @param src il file sorgente
+ * @param dest il file di destinazione
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int atomicCopy(const char *src, const char *dest)
+{
+    char *tmp;
+    char buf[BUFSIZ];
+    size_t n;
+    int ret = -1;
+
+    FILE *in = fopen(src, "rb");
+    if (in == NULL)
+        return -1;
+
+    asprintf(&tmp, "%s.XXXXXX", dest);
+    int fd = mkstemp(tmp);
+    FILE *out = (fd == -1) ? NULL : fdopen(fd, "wb");
+    if (out == NULL)
+    {
+        if (fd != -1)
+        {
+            close(fd);
+            unlink(tmp);
+        }
+        goto end;
+    }
+
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+        if (fwrite(buf, 1, n, out) != n)
+            break;
+
+    int err = ferror(in) || ferror(out);
+    if ((fclose(out) != 0) || err || (rename(tmp, dest) == -1))
+        unlink(tmp);
+    else
+        ret = 0;
+
+end:
+    fclose(in);
+    free(tmp);
+    return ret;
+}
+
+int fcache_store(const char *dir, const char *key, const char *min_file)
+{
+    char *dest;
+    int ret;
+
+    asprintf(&dest, "%s%s" MIN_SUFFIX, dir, key);
+    ret = atomicCopy(min_file, dest);
+    free(dest);
+
+    return ret;
+}
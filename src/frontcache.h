@@ -0,0 +1,44 @@
+#ifndef _FRONTCACHE_H
+#define _FRONTCACHE_H
+
+/**
+ * @file frontcache.h
+ * @author Marco Costa
+ * @brief Cache su disco dei risultati di espresso (copertura minimizzata),
+ *  indirizzata dal contenuto della PLA di ingresso e dal tipo di minimizzazione
+ */
+
+/* lunghezza massima di una chiave, incluso il terminatore */
+#define FCACHE_KEY_LEN 64
+
+/**
+ * @brief Calcolo della chiave di cache di una PLA
+ *
+ * @param inputfile il file PLA
+ * @param key la chiave (almeno FCACHE_KEY_LEN caratteri)
+ * @return int -1 se il file non è leggibile, 0 altrimenti
+ */
+int fcache_key(const char *inputfile, char *key);
+
+/**
+ * @brief Ricerca di una voce in cache
+ *
+ * @param dir la directory della cache (terminata da '/')
+ * @param key la chiave
+ * @param min_file il percorso della copertura minimizzata in cache, da liberare con free
+ * @return int 0 se la voce è presente, -1 altrimenti (min_file invariato)
+ */
+int fcache_lookup(const char *dir, const char *key, char **min_file);
+
+/**
+ * @brief Inserimento di una voce in cache. Il file viene scritto in un file
+ *  temporaneo e rinominato, quindi più processi possono condividere la cache
+ *
+ * @param dir la directory della cache (terminata da '/')
+ * @param key la chiave
+ * @param min_file la copertura minimizzata da copiare
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int fcache_store(const char *dir, const char *key, const char *min_file);
+
+#endif
@@ -8,97 +8,77 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "libpla.h"
 #include "utils.h"
 
 void initParsedPLA(ParsedPLA *bdd)
 {
-    CUBE_LIST = safe_malloc(bdd->num_out * sizeof(TAILQ_HEAD(queue, CubeListEntry)));
-    for (int i = 0; i < bdd->num_out; i++)
-        TAILQ_INIT(&(CUBE_LIST[i]));
-    N_CUBES = safe_calloc(bdd->num_out, sizeof(int));
+    arena_init(&(bdd->arena), 0);
+    bdd->cubes = safe_calloc(bdd->num_out, sizeof(CubeArray));
 }
 
-CubeListEntry *alloc_node(int size)
+void freeCubes(ParsedPLA *bdd)
 {
-    CubeListEntry *c = safe_malloc(sizeof(CubeListEntry));
-    c->cube = safe_malloc(size * sizeof(int));
-    return c;
+    arena_free(&(bdd->arena));
+    free(bdd->cubes);
+    bdd->cubes = NULL;
 }
 
-void convertDCSetPLA(char *filename)
+int cube_append(ParsedPLA *pla, int o, const int *cube)
 {
-    FILE *ft;
-    int ch;
-    char skip_buf[1024];
+    CubeArray *a = &(pla->cubes[o]);
+    size_t cube_size = pla->num_in * sizeof(int);
 
-    ft = fopen(filename, "r+");
-    if (ft == NULL)
+    if (a->len == a->size)
     {
-        fprintf(stderr, "cannot open target file %s\n", filename);
-        exit(1);
-    }
+        /* il vettore precedente resta nell'arena fino al rilascio */
+        int size = a->size ? a->size * 2 : CUBES_INIT_SIZE;
+        int *cubes = arena_alloc(&(pla->arena), size * cube_size);
+        char *alive = arena_alloc(&(pla->arena), size);
 
-    while ((ch = fgetc(ft)) != EOF)
-    {
-        if (ch == '.')
-            fgets(skip_buf, 1024, ft);
-        else if (ch == '~')
+        if (a->len > 0)
         {
-            fseek(ft, -1, SEEK_CUR);
-            fputc('0', ft);
-            fseek(ft, 0, SEEK_CUR);
-        }
-        else if (ch == '2')
-        {
-            fseek(ft, -1, SEEK_CUR);
-            fputc('1', ft);
-            fseek(ft, 0, SEEK_CUR);
+            memcpy(cubes, a->cubes, a->len * cube_size);
+            memcpy(alive, a->alive, a->len);
         }
+        a->cubes = cubes;
+        a->alive = alive;
+        a->size = size;
     }
-    fclose(ft);
+
+    memcpy(a->cubes + (size_t)a->len * pla->num_in, cube, cube_size);
+    a->alive[a->len] = 1;
+    a->literals += cube_literals(cube, pla->num_in);
+    return a->len++;
 }
 
-void printMatrixtoFile(char *filename, int **M, int len, int in, int out)
+void cube_compact(ParsedPLA *pla, int o)
 {
-    FILE *f = fopen(filename, "w+");
-    if (f == NULL)
-    {
-        fprintf(stderr, "Impossibile aprire il file %s:", filename);
-        perror(NULL);
-        exit(EXIT_FAILURE);
-    }
+    CubeArray *a = &(pla->cubes[o]);
+    size_t cube_size = pla->num_in * sizeof(int);
+    int j = 0;
 
-    fprintf(f, ".i %d\n.o %d\n", in, out);
-    for (int i = 0; i < len; i++)
+    if (a->dead == 0)
+        return;
+
+    for (int i = 0; i < a->len; i++)
     {
-        for (int j = 0; j < (in + out); j++)
-        {
-            if (j == in)
-            {
-                // printf(" ");
-                fprintf(f, " ");
-            }
-            if (M[i][j] == 2)
-            {
-                // printf("-");
-                fprintf(f, "-");
-            }
-            else
-            {
-                // printf("%d", M[i][j]);
-                fprintf(f, "%d", M[i][j]);
-            }
-        }
-        // printf("\n");
-        fprintf(f, "\n");
+        if (!a->alive[i])
+            continue;
+        if (i != j)
+            memcpy(a->cubes + (size_t)j * pla->num_in, a->cubes + (size_t)i * pla->num_in, cube_size);
+        a->alive[j++] = 1;
     }
-
-    fclose(f);
+    a->len = j;
+    a->dead = 0;
 }
 
-void getPLAFileData(char *filename, int function_out, struct test_stats *s)
+int getPLAFileData(char *filename, int function_out, struct test_stats *s)
 {
     FILE *ft;
     int ch;
@@ -106,15 +86,15 @@ void getPLAFileData(char *filename, int function_out, struct test_stats *s)
     int output = 0, curr_line_literals = 0, curr_function_out = 0;
     int in_n = 0, out_n = 0, tot_product = 0;
 
-    int *or_literals = safe_calloc(function_out, sizeof(int));
-
     ft = fopen(filename, "r+");
     if (ft == NULL)
     {
         fprintf(stderr, "cannot open target file %s\n", filename);
-        exit(1);
+        return -1;
     }
 
+    int *or_literals = safe_calloc(function_out, sizeof(int));
+
     while ((ch = fgetc(ft)) != EOF)
     {
         if (ch == ' ')
@@ -155,4 +135,230 @@ void getPLAFileData(char *filename, int function_out, struct test_stats *s)
     s->prod_out = out_n;
 
     free(or_literals);
-}
\ No newline at end of file
+    return 0;
+}
+/**
+ * @brief Scrittura del buffer sul descrittore
+ */
+static void flushWriter(PlaWriter *w)
+{
+    size_t done = 0;
+
+    while (done < w->len)
+    {
+        ssize_t n = write(w->fd, w->buf + done, w->len - done);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            w->error = 1;
+            break;
+        }
+        done += n;
+    }
+    w->len = 0;
+}
+
+int pla_writer_open(PlaWriter *w, const char *filename, int num_in, int num_out)
+{
+    if (strcmp(filename, "-") == 0)
+    {
+        w->fd = STDOUT_FILENO;
+        w->own_fd = 0;
+        fflush(stdout);
+    }
+    else
+    {
+        w->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (w->fd == -1)
+        {
+            fprintf(stderr, "Impossibile aprire il file %s:", filename);
+            perror(NULL);
+            return -1;
+        }
+        w->own_fd = 1;
+    }
+
+    w->num_in = num_in;
+    w->num_out = num_out;
+    w->buf = safe_malloc(PLA_WRITER_BUF_SIZE);
+    w->error = 0;
+    w->len = snprintf(w->buf, PLA_WRITER_BUF_SIZE, ".i %d\n.o %d\n", num_in, num_out);
+    return 0;
+}
+
+void pla_writer_row(PlaWriter *w, const int *cube, const char *outs)
+{
+    static const char literal[] = {'0', '1', '-'};
+    size_t row = w->num_in + w->num_out + 2;
+
+    if (w->len + row > PLA_WRITER_BUF_SIZE)
+        flushWriter(w);
+
+    /* righe più lunghe del buffer: scritte a pezzi */
+    if (row > PLA_WRITER_BUF_SIZE)
+    {
+        for (int i = 0; i < w->num_in; i++)
+        {
+            if (w->len == PLA_WRITER_BUF_SIZE)
+                flushWriter(w);
+            w->buf[w->len++] = literal[cube[i]];
+        }
+        flushWriter(w);
+        dprintf(w->fd, " %.*s\n", w->num_out, outs);
+        return;
+    }
+
+    char *p = w->buf + w->len;
+    for (int i = 0; i < w->num_in; i++)
+        *p++ = literal[cube[i]];
+    *p++ = ' ';
+    memcpy(p, outs, w->num_out);
+    p += w->num_out;
+    *p++ = '\n';
+    w->len = p - w->buf;
+}
+
+int pla_writer_close(PlaWriter *w)
+{
+    flushWriter(w);
+    free(w->buf);
+    w->buf = NULL;
+
+    if (w->own_fd && (close(w->fd) == -1))
+        w->error = 1;
+
+    return w->error ? -1 : 0;
+}
+
+/**
+ * @brief Hash FNV-1a degli ingressi di un prodotto
+ */
+static unsigned int hashCube(const int *cube, int n)
+{
+    unsigned int h = 2166136261u;
+
+    for (int i = 0; i < n; i++)
+        h = (h ^ (unsigned int)cube[i]) * 16777619u;
+    return h;
+}
+
+/**
+ * @brief Ridimensionamento della tabella hash a n_slots posizioni
+ */
+static void rehashRows(PlaRows *r, int n_slots)
+{
+    free(r->slot);
+    r->slot = safe_calloc(n_slots, sizeof(int));
+    r->n_slots = n_slots;
+
+    for (int i = 0; i < r->len; i++)
+    {
+        unsigned int h = hashCube(r->cube[i], r->num_in) & (n_slots - 1);
+        while (r->slot[h] != 0)
+            h = (h + 1) & (n_slots - 1);
+        r->slot[h] = i + 1;
+    }
+}
+
+void pla_rows_init(PlaRows *r, int num_in, int num_out)
+{
+    memset(r, 0, sizeof(PlaRows));
+    r->num_in = num_in;
+    r->num_out = num_out;
+    arena_init(&(r->copies), 0);
+    rehashRows(r, 64);
+}
+
+int pla_rows_index(PlaRows *r, const int *cube, int copy)
+{
+    unsigned int mask = r->n_slots - 1;
+    unsigned int h = hashCube(cube, r->num_in) & mask;
+
+    for (; r->slot[h] != 0; h = (h + 1) & mask)
+    {
+        int i = r->slot[h] - 1;
+        if (memcmp(r->cube[i], cube, r->num_in * sizeof(int)) == 0)
+            return i;
+    }
+
+    if (r->len == r->size)
+    {
+        r->size = r->size ? 2 * r->size : 64;
+        r->cube = safe_realloc(r->cube, r->size * sizeof(int *));
+        r->outs = safe_realloc(r->outs, (size_t)r->size * r->num_out);
+    }
+
+    if (copy)
+    {
+        int *c = arena_alloc(&(r->copies), r->num_in * sizeof(int));
+        memcpy(c, cube, r->num_in * sizeof(int));
+        cube = c;
+    }
+
+    int i = r->len++;
+    r->cube[i] = cube;
+    r->slot[h] = i + 1;
+    memset(r->outs + (size_t)i * r->num_out, '0', r->num_out);
+
+    /* fattore di carico massimo 1/2 */
+    if (2 * r->len > r->n_slots)
+        rehashRows(r, 2 * r->n_slots);
+
+    return i;
+}
+
+char *pla_rows_get(PlaRows *r, const int *cube, int copy)
+{
+    /* l'indice va calcolato prima di leggere outs, che può essere riallocato */
+    int i = pla_rows_index(r, cube, copy);
+    return r->outs + (size_t)i * r->num_out;
+}
+
+int pla_rows_write(PlaRows *r, const char *filename)
+{
+    PlaWriter w;
+
+    if (pla_writer_open(&w, filename, r->num_in, r->num_out) == -1)
+        return -1;
+    for (int i = 0; i < r->len; i++)
+        pla_writer_row(&w, r->cube[i], r->outs + (size_t)i * r->num_out);
+
+    return pla_writer_close(&w);
+}
+
+void pla_rows_free(PlaRows *r)
+{
+    arena_free(&(r->copies));
+    free(r->cube);
+    free(r->outs);
+    free(r->slot);
+    memset(r, 0, sizeof(PlaRows));
+}
+
+void pla_stats(ParsedPLA *pla, struct test_stats *s)
+{
+    PlaRows rows;
+
+    memset(s, 0, sizeof(struct test_stats));
+    pla_rows_init(&rows, pla->num_in, pla->num_out);
+    for (int o = 0; o < pla->num_out; o++)
+    {
+        s->and_lit += pla->cubes[o].literals;
+        s->or_port += cube_count(pla, o);
+
+        /* letterali di ingresso contati una volta per riga */
+        for (int i = 0; i < pla->cubes[o].len; i++)
+        {
+            if (!cube_alive(pla, o, i))
+                continue;
+
+            int len = rows.len;
+            pla_rows_get(&rows, cube_at(pla, o, i), 0);
+            if (rows.len > len)
+                s->prod_in += cube_literals(cube_at(pla, o, i), pla->num_in);
+        }
+    }
+    s->prod_out = s->or_port;
+    pla_rows_free(&rows);
+}
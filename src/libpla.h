@@ -10,20 +10,26 @@
 
 #include <stdio.h>
 #include <cudd.h>
-#include <sys/queue.h>
 
-DdManager *manager; /**< CUDD manager */
+#include "arena.h"
 
-typedef struct CubeListEntry
-{
-    int *cube;
-    TAILQ_ENTRY(CubeListEntry)
-    entries;
-} CubeListEntry;
+/* capacità iniziale dei vettori di prodotti */
+#define CUBES_INIT_SIZE 16
 
-int *N_CUBES;
-TAILQ_HEAD(queue, CubeListEntry)
-*CUBE_LIST;
+/**
+ * @brief Prodotti di un output in un vettore contiguo allocato dall'arena della
+ *  ParsedPLA. I prodotti rimossi restano come tombstone fino alla compattazione:
+ *  gli indici sono stabili tra due compattazioni
+ */
+typedef struct CubeArray
+{
+    int *cubes;  /**< len prodotti consecutivi da num_in letterali */
+    char *alive; /**< 0 per i prodotti rimossi */
+    int len;     /**< prodotti inseriti, inclusi i rimossi */
+    int size;    /**< capacità */
+    int dead;    /**< prodotti rimossi */
+    int literals; /**< letterali dei prodotti non rimossi */
+} CubeArray;
 
 typedef struct ParsedPLA
 {
@@ -31,6 +37,9 @@ typedef struct ParsedPLA
     int num_x;            /**< number of x variables */
     int num_out;          /**< number of output */
     DdNode **vectorbdd_F; /**< BDD array for output */
+    CubeArray *cubes;     /**< products for each output (only if minimized) */
+    int in_literals;      /**< input literals of the rows read from file (only if minimized) */
+    Arena arena;          /**< memory of the products */
 } ParsedPLA;
 
 /**
@@ -51,11 +60,15 @@ static inline void print_verbose_stats(struct test_stats s)
 }
 
 /**
- * @brief Converte un file PLA in un file PLA contenente unicamente il DC-set
- * 
- * @param filename il file
+ * @brief Numero di letterali e prodotti della PLA formata dai prodotti non rimossi,
+ *  come getPLAFileData sul file scritto dalla struttura: i prodotti uguali di
+ *  output diversi formano una sola riga. Letterali AND e porte OR sono mantenuti
+ *  dai vettori di prodotti, i letterali delle righe richiedono una scansione
+ *
+ * @param pla la struttura
+ * @param s la struttura dei dati
  */
-void convertDCSetPLA(char *filename);
+void pla_stats(ParsedPLA *pla, struct test_stats *s);
 
 /**
  * @brief Ottiene il numero di letterali e prodotti da un file PLA
@@ -63,33 +76,191 @@ void convertDCSetPLA(char *filename);
  * @param filename il file
  * @param function_out il numero di uscite della funzione
  * @param s la struttura
+ * @return int -1 se il file non può essere aperto, 0 altrimenti
  */
-void getPLAFileData(char *filename, int function_out, struct test_stats *s);
+int getPLAFileData(char *filename, int function_out, struct test_stats *s);
 
 /**
- * @brief Inizializzazione di una struttura ParsedPLA
+ * @brief Inizializzazione dei vettori di prodotti di una struttura ParsedPLA
  * 
  * @param bdd la struttura
  */
 void initParsedPLA(ParsedPLA *bdd);
 
 /**
- * @brief Inizializzazione di una struttura CubeListEntry di dimensione size
+ * @brief Rilascio in un unico passo dei vettori di prodotti di una struttura ParsedPLA
+ * 
+ * @param bdd la struttura
+ */
+void freeCubes(ParsedPLA *bdd);
+
+/**
+ * @brief Aggiunta di un prodotto in coda ai prodotti dell'output o
  * 
- * @param size 
- * @return CubeListEntry* 
+ * @param pla la struttura
+ * @param o l'output
+ * @param cube il prodotto (num_in letterali)
+ * @return int l'indice del prodotto
  */
-CubeListEntry *alloc_node(int size);
+int cube_append(ParsedPLA *pla, int o, const int *cube);
 
 /**
- * @brief Stampa di una matrice come file PLA.
+ * @brief Compattazione dei prodotti dell'output o: i tombstone vengono eliminati
+ *  e gli indici dei prodotti cambiano
  * 
- * @param filename il file di out
- * @param M la matrice
- * @param len numero di righe
- * @param in numero di ingressi
- * @param out numero di uscite
+ * @param pla la struttura
+ * @param o l'output
+ */
+void cube_compact(ParsedPLA *pla, int o);
+
+/**
+ * @brief Prodotto di indice i dell'output o, valido fino alla prossima aggiunta
+ */
+static inline int *cube_at(ParsedPLA *pla, int o, int i)
+{
+    return pla->cubes[o].cubes + (size_t)i * pla->num_in;
+}
+
+/**
+ * @brief Se il prodotto di indice i dell'output o non è stato rimosso
+ */
+static inline int cube_alive(ParsedPLA *pla, int o, int i)
+{
+    return pla->cubes[o].alive[i];
+}
+
+/**
+ * @brief Numero di letterali (ingressi a 0 o 1) di un prodotto
+ */
+static inline int cube_literals(const int *cube, int n)
+{
+    int lit = 0;
+
+    for (int i = 0; i < n; i++)
+        lit += (cube[i] != 2);
+    return lit;
+}
+
+/**
+ * @brief Rimozione del prodotto di indice i dell'output o
+ */
+static inline void cube_remove(ParsedPLA *pla, int o, int i)
+{
+    if (pla->cubes[o].alive[i])
+    {
+        pla->cubes[o].alive[i] = 0;
+        pla->cubes[o].dead++;
+        pla->cubes[o].literals -= cube_literals(cube_at(pla, o, i), pla->num_in);
+    }
+}
+
+/**
+ * @brief Numero di prodotti non rimossi dell'output o
+ */
+static inline int cube_count(ParsedPLA *pla, int o)
+{
+    return pla->cubes[o].len - pla->cubes[o].dead;
+}
+
+/* dimensione del buffer di scrittura delle PLA */
+#define PLA_WRITER_BUF_SIZE (64 * 1024)
+
+/**
+ * @brief Scrittura bufferizzata di un file PLA: le righe vengono formattate in un
+ *  buffer e scritte con una sola write quando il buffer è pieno
+ */
+typedef struct PlaWriter
+{
+    int fd;      /**< descrittore di destinazione */
+    int own_fd;  /**< se fd va chiuso alla fine (non per lo stdout) */
+    int num_in;  /**< numero di ingressi */
+    int num_out; /**< numero di uscite */
+    char *buf;   /**< buffer delle righe */
+    size_t len;  /**< byte nel buffer */
+    int error;   /**< se una scrittura è fallita */
+} PlaWriter;
+
+/**
+ * @brief Righe di una PLA con gli ingressi uniti tra gli output: ogni prodotto
+ *  distinto è una riga, nell'ordine del primo inserimento
+ */
+typedef struct PlaRows
+{
+    int num_in, num_out;
+    const int **cube; /**< ingressi di ogni riga */
+    char *outs;       /**< num_out caratteri di uscita per riga */
+    int len, size;    /**< righe e capacità */
+    int *slot;        /**< tabella hash: indice della riga + 1, 0 se libero */
+    int n_slots;      /**< dimensione della tabella, potenza di 2 */
+    Arena copies;     /**< copie dei prodotti non stabili (generatori di CUDD) */
+} PlaRows;
+
+/**
+ * @brief Apertura di un file PLA in scrittura e scrittura dell'intestazione
+ *
+ * @param w il writer
+ * @param filename il file, "-" per lo stdout
+ * @param num_in numero di ingressi
+ * @param num_out numero di uscite
+ * @return int -1 se il file non può essere aperto, 0 altrimenti
+ */
+int pla_writer_open(PlaWriter *w, const char *filename, int num_in, int num_out);
+
+/**
+ * @brief Aggiunta di una riga
+ *
+ * @param w il writer
+ * @param cube gli ingressi (0, 1, 2 per il don't care)
+ * @param outs i num_out caratteri delle uscite
+ */
+void pla_writer_row(PlaWriter *w, const int *cube, const char *outs);
+
+/**
+ * @brief Scrittura del buffer e chiusura del file
+ *
+ * @param w il writer
+ * @return int -1 se una scrittura è fallita, 0 altrimenti
+ */
+int pla_writer_close(PlaWriter *w);
+
+/**
+ * @brief Inizializzazione di un insieme di righe vuoto
+ */
+void pla_rows_init(PlaRows *r, int num_in, int num_out);
+
+/**
+ * @brief Indice della riga con ingressi cube, aggiunta con uscite a '0' se non presente
+ *
+ * @param r le righe
+ * @param cube gli ingressi
+ * @param copy se cube va copiato perché non resta valido fino alla scrittura
+ * @return int l'indice della riga, r->len - 1 se è stata appena aggiunta
+ */
+int pla_rows_index(PlaRows *r, const int *cube, int copy);
+
+/**
+ * @brief Riga con ingressi cube, aggiunta con uscite a '0' se non presente
+ *
+ * @param r le righe
+ * @param cube gli ingressi
+ * @param copy se cube va copiato perché non resta valido fino alla scrittura
+ * @return char* i num_out caratteri delle uscite della riga, validi fino alla
+ *  prossima aggiunta
+ */
+char *pla_rows_get(PlaRows *r, const int *cube, int copy);
+
+/**
+ * @brief Scrittura delle righe come file PLA
+ *
+ * @param r le righe
+ * @param filename il file, "-" per lo stdout
+ * @return int -1 se una scrittura è fallita, 0 altrimenti
+ */
+int pla_rows_write(PlaRows *r, const char *filename);
+
+/**
+ * @brief Rilascio delle righe
  */
-void printMatrixtoFile(char *filename, int **M, int len, int in, int out);
+void pla_rows_free(PlaRows *r);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,2848 @@
+/**
+ * @file libsop.c
+ * @author Marco Costa
+ * @brief Implementazione del motore di sintesi: euristica, decomposizione e gestione in/out
+ * @date 2019-11-21
+ *
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <math.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <libgen.h>
+#include <dirent.h>
+#include <pthread.h>
+
+#include <cudd.h>
+
+#include "PLAparser.h"
+
+#include "libsop.h"
+#include "frontcache.h"
+#include "cover.h"
+#include "portfolio.h"
+#include "queue.h"
+#include "libpla.h"
+#include "config.h"
+#include "utils.h"
+
+/* nomi dei front-end, riportati nel CSV */
+static const char *frontend_names[N_FRONTENDS] = {"espresso", "isop", "isop-expand"};
+static const char *decomposition_names[N_DECOMPOSITIONS] = {"and", "best"};
+
+/* coda limitata: candidati conservati per output oltre a quelli derivati dall'errore */
+#define BOUND_MIN_K 16
+
+/**
+ * @brief Costruisce una PLA data una struttura ParsedPLA
+ *
+ * @param ctx il contesto
+ * @param pla la struttura
+ * @param filename il file di out, "-" per lo stdout
+ * @return int -1 se la scrittura fallisce, 0 altrimenti
+ */
+static int mergeToPLA(SopContext *ctx, ParsedPLA *pla, const char *filename)
+{
+    PlaRows rows;
+
+    /* i prodotti uguali di output diversi formano una sola riga */
+    pla_rows_init(&rows, ctx->num_in, ctx->num_out);
+    for (int o = 0; o < ctx->num_out; o++)
+        for (int j = 0; j < pla->cubes[o].len; j++)
+            if (cube_alive(pla, o, j))
+                pla_rows_get(&rows, cube_at(pla, o, j), 0)[o] = '1';
+
+    int ret = pla_rows_write(&rows, filename);
+    if (ret == -1)
+        fprintf(stderr, "[!!] impossibile scrivere %s\n", filename);
+    pla_rows_free(&rows);
+
+    return ret;
+}
+
+/**
+ * @brief Costruisce una BDD contenente un singolo prodotto
+ *
+ * @param manager il CUDD manager
+ * @param cube il prodotto come vettore di interi
+ * @param n_var il numero di variabili
+ * @return DdNode* la BDD
+ */
+static DdNode *construct_product(DdManager *manager, int *cube, int n_var)
+{
+    DdNode *temp_node;
+    DdNode *new_node = Cudd_ReadOne(manager);
+    Cudd_Ref(new_node);
+
+    for (int i = 0; i < n_var; i++)
+    {
+        DdNode *var = Cudd_bddIthVar(manager, i);
+        if (cube[i] == 0) /* effettua il complemento */
+            temp_node = Cudd_bddAnd(manager, new_node, Cudd_Not(var));
+        else if (cube[i] == 1)
+            temp_node = Cudd_bddAnd(manager, new_node, var);
+        else
+            continue;
+
+        Cudd_Ref(temp_node);
+        Cudd_RecursiveDeref(manager, new_node);
+        new_node = temp_node;
+    }
+
+    return new_node;
+}
+
+/**
+ * @brief Operatore di copertura mediante confronto tra due vettori di interi
+ *
+ * @param a
+ * @param b
+ * @return int 1 sse a copre b, 2 se a == b,  0 altrimenti
+ */
+static int covers(int *a, int *b, int n_in)
+{
+    int equals = 2;
+    for (int i = 0; i < n_in; i++)
+    {
+        if (a[i] == 2 && b[i] != 2)
+            equals = 1; /* non sono uguali */
+        else if (a[i] != 2 && a[i] != b[i])
+            return 0;
+    }
+
+    return equals;
+}
+
+/**
+ * @brief Rimozione dei prodotti ridondanti in coda
+ *
+ * @param prod il prodotto inserito in coda
+ * @param q la coda
+ * @param n_in il numero di var. di input
+ * @return int il numero di prodotti invalidati
+ */
+static int invalidateRedundantInQueue(product_t *prod, prior_queue *q, int n_in)
+{
+    int invalidated = 0, origin = prod->product_number;
+
+    for (int i = 0; i < q->len; i++)
+    {
+        product_t *curr_prod = queue_at(q, i);
+
+        if ((curr_prod == NULL) || (curr_prod->valid == 0) || (prod->output_f != curr_prod->output_f))
+            continue;
+
+        /* c'è un prodotto uguale sullo stesso output */
+        if (memcmp(prod->cube, curr_prod->cube, n_in * sizeof(int)) == 0)
+        {
+            curr_prod->valid = 0;
+            invalidated++;
+        }
+        else if (curr_prod->product_number == origin)
+        {
+            /* proveniente dalla stessa origine: resta valido se generato anche da un'altra */
+            if (curr_prod->n_origins == 0)
+            {
+                curr_prod->valid = 0;
+                invalidated++;
+            }
+            else
+            {
+                curr_prod->product_number = curr_prod->origins[0];
+                memmove(curr_prod->origins, curr_prod->origins + 1, --(curr_prod->n_origins) * sizeof(int));
+            }
+        }
+        else
+            for (int k = 0; k < curr_prod->n_origins; k++)
+                if (curr_prod->origins[k] == origin)
+                {
+                    memmove(curr_prod->origins + k, curr_prod->origins + k + 1,
+                            (--(curr_prod->n_origins) - k) * sizeof(int));
+                    break;
+                }
+    }
+
+    return invalidated;
+}
+
+/**
+ * @brief Conteggio dei prodotti della lista dell'output o coperti da cube
+ *
+ * @param pla la lista di prodotti
+ * @param cube il prodotto espanso
+ * @param o l'output
+ * @param n_in numero di ingressi
+ * @return int il numero di prodotti coperti, -1 se cube è già presente nella lista
+ */
+static int countCovered(ParsedPLA *pla, int *cube, int o, int n_in)
+{
+    int covered_prod = 0;
+
+    for (int j = 0; j < pla->cubes[o].len; j++)
+    {
+        if (!cube_alive(pla, o, j))
+            continue;
+
+        int ret = covers(cube, cube_at(pla, o, j), n_in);
+
+        if (ret == 1) /* a copre b ma a != b */
+            covered_prod++;
+        else if (ret == 2) /* il prodotto è già presente nella PLA */
+            return -1;
+    }
+
+    return covered_prod;
+}
+
+/**
+ * @brief Rimozione dei prodotti nella lista coperti da prod.
+ *
+ * @param ctx il contesto
+ * @param prod il nuovo prodotto
+ * @param pla la lista di prodotti
+ * @return int il numero di prodotti rimossi
+ */
+static int removeCoveredProducts(SopContext *ctx, product_t *prod, ParsedPLA *pla)
+{
+    int o = prod->output_f, removed = 0;
+
+    for (int i = 0; i < pla->cubes[o].len; i++)
+        if (cube_alive(pla, o, i) && covers(prod->cube, cube_at(pla, o, i), ctx->num_in))
+        {
+            cube_remove(pla, o, i);
+            removed++;
+        }
+
+    /* compattazione quando i tombstone superano la metà dei prodotti */
+    if (2 * pla->cubes[o].dead > pla->cubes[o].len)
+        cube_compact(pla, o);
+
+    return removed;
+}
+
+/**
+ * @brief Rilascio delle BDD e delle liste di prodotti di una struttura ParsedPLA
+ *
+ * @param manager il CUDD manager
+ * @param pla la struttura
+ */
+static void freeParsedPLA(DdManager *manager, ParsedPLA *pla)
+{
+    if (pla->vectorbdd_F != NULL)
+        for (int o = 0; o < pla->num_out; o++)
+            Cudd_RecursiveDeref(manager, pla->vectorbdd_F[o]);
+
+    if (pla->cubes != NULL)
+        freeCubes(pla);
+    free(pla->vectorbdd_F);
+    memset(pla, 0, sizeof(ParsedPLA));
+}
+
+/**
+ * @brief Routine di pulizia.
+ *
+ * @param ctx il contesto
+ */
+static void cleanRoutine(SopContext *ctx)
+{
+    ckpt_discard(ctx);
+    incr_free(ctx);
+
+    if (ctx->offset != NULL)
+    {
+        for (int o = 0; o < ctx->num_out; o++)
+            Cudd_RecursiveDeref(ctx->manager, ctx->offset[o]);
+        free(ctx->offset);
+        ctx->offset = NULL;
+    }
+
+    freeParsedPLA(ctx->manager, &(ctx->minimized));
+    freeParsedPLA(ctx->manager, &(ctx->dcset));
+
+    free(ctx->stream_input);
+    free(ctx->stream_min);
+    ctx->stream_input = ctx->stream_min = NULL;
+    free(ctx->output_stats);
+    ctx->output_stats = NULL;
+    arena_free(&(ctx->candidates));
+}
+
+/**
+ * @brief Destinazione dei prodotti di una copertura
+ */
+typedef struct CoverTarget
+{
+    PlaRows *rows;
+    PlaWriter *writer;
+    const char *outs;
+    int o;
+    char value;
+} CoverTarget;
+
+/**
+ * @brief Assegnamento di un prodotto della copertura all'output o delle righe
+ */
+static void coverToRows(const int *cube, void *arg)
+{
+    CoverTarget *t = arg;
+
+    pla_rows_get(t->rows, cube, 1)[t->o] = t->value;
+}
+
+/**
+ * @brief Scrittura di un prodotto della copertura come riga del file
+ */
+static void coverToWriter(const int *cube, void *arg)
+{
+    CoverTarget *t = arg;
+
+    pla_writer_row(t->writer, cube, t->outs);
+}
+
+/**
+ * @brief Copertura irridondante di lower <= f <= upper dell'output o
+ *
+ * @return int -1 se la copertura non può essere calcolata, 0 altrimenti
+ */
+static int writeCover(SopContext *ctx, DdNode *lower, DdNode *upper, CoverCubeFn fn, void *arg, int o)
+{
+    if (cover_isop(ctx->manager, lower, upper, ctx->num_in, fn, arg) == -1)
+    {
+        fprintf(stderr, "[!!] impossibile calcolare la copertura dell'output %d\n", o);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Costruisce un file PLA a partire dall'On-set e DC-set di una funzione.
+ *
+ * @param ctx il contesto
+ * @param filename il file di out
+ * @param on_set BDD rappresentante l'On-set
+ * @param dc_set BDD rappresentante il DC-set
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int mergeBDDtoFile(SopContext *ctx, char *filename, DdNode **on_set, DdNode **dc_set)
+{
+    DdManager *manager = ctx->manager;
+    PlaRows rows;
+    CoverTarget t = {&rows, NULL, NULL, 0, 0};
+    int ret = 0;
+
+    /* l'On-set può estendersi sul DC-set, un prodotto del DC-set prevale sull'On-set */
+    pla_rows_init(&rows, ctx->num_in, ctx->num_out);
+    for (t.o = 0; (t.o < ctx->num_out) && (ret == 0); t.o++)
+    {
+        DdNode *upper = Cudd_bddOr(manager, on_set[t.o], dc_set[t.o]);
+        Cudd_Ref(upper);
+
+        t.value = '1';
+        ret = writeCover(ctx, on_set[t.o], upper, coverToRows, &t, t.o);
+        t.value = '-';
+        if (ret == 0)
+            ret = writeCover(ctx, dc_set[t.o], dc_set[t.o], coverToRows, &t, t.o);
+
+        Cudd_RecursiveDeref(manager, upper);
+    }
+
+    if ((ret == 0) && (pla_rows_write(&rows, filename) == -1))
+    {
+        fprintf(stderr, "[!!] impossibile scrivere %s\n", filename);
+        ret = -1;
+    }
+    pla_rows_free(&rows);
+
+    return ret;
+}
+
+/**
+ * @brief Riscrittura di g_file e f_file in formato fr senza intestazioni di tipo,
+ *  nei file g_file e f_file del contesto
+ */
+static void echoDecompositionInputs(SopContext *ctx, char *g_file, char *f_file)
+{
+    SopPaths *p = &(ctx->paths);
+    char *command;
+
+    asprintf(&command, "espresso -Decho -of %s | sed -e '/\\.[p-type]/d' > %s", g_file, p->g_file);
+    system(command);
+    free(command);
+    asprintf(&command, "espresso -Decho -of %s | sed -e '/\\.[p-type]/d' > %s", f_file, p->f_file);
+    system(command);
+    free(command);
+}
+
+/**
+ * @brief Verifica con espresso che la funzione ricomposta sia equivalente a f_file
+ *
+ * @return int -1 se la verifica fallisce, 0 altrimenti
+ */
+static int verifyDecomposition(SopContext *ctx, char *f_file)
+{
+    char *command;
+
+    if (ctx->output_mode == VERBOSE_LOG)
+    {
+        printf("\n**************************\n");
+        fflush(stdout);
+        asprintf(&command, "espresso -Dverify %s %s", f_file, ctx->paths.g_times_h);
+    }
+    else
+        asprintf(&command, "espresso -Dverify %s %s >> /dev/null 2>> /dev/null", f_file, ctx->paths.g_times_h);
+
+    int ret = system(command);
+    free(command);
+    if (ret != 0)
+    {
+        fprintf(stderr, "[!!] decomposition failed\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Scrittura della funzione ricomposta, un output alla volta, per la verifica
+ *
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int writeRecomposed(SopContext *ctx, DdNode **out)
+{
+    int num_out = ctx->num_out;
+    PlaWriter eq;
+    int ret = 0;
+
+    if (pla_writer_open(&eq, ctx->paths.g_times_h, ctx->num_in, num_out) == -1)
+        return -1;
+
+    char *curr_onset = safe_calloc((num_out + 1), sizeof(char));
+    CoverTarget t = {NULL, &eq, curr_onset, 0, '1'};
+    for (t.o = 0; (t.o < num_out) && (ret == 0); t.o++)
+    {
+        for (int i = 0; i < num_out; i++)
+            curr_onset[i] = (i == t.o) ? '1' : '0';
+
+        ret = writeCover(ctx, out[t.o], out[t.o], coverToWriter, &t, t.o);
+    }
+
+    if ((pla_writer_close(&eq) == -1) && (ret == 0))
+    {
+        fprintf(stderr, "[!!] impossibile scrivere %s\n", ctx->paths.g_times_h);
+        ret = -1;
+    }
+    free(curr_onset);
+
+    return ret;
+}
+
+/**
+ * @brief Procedura per la decomposizione euristica di una funzione f data la sua approssimazione g
+ *  mediante operatore logico AND
+ *
+ * @param ctx il contesto
+ * @param f_dc il DC-set della funzione f
+ * @param g_file il file PLA della funzione g
+ * @param f_file il file PLA della funzione f
+ * @return int -1 se la decomposizione o la sua verifica fallisce, 0 altrimenti
+ */
+static int andDecomposition(SopContext *ctx, ParsedPLA *f_dc, char *g_file, char *f_file)
+{
+    DdManager *manager = ctx->manager;
+    SopPaths *p = &(ctx->paths);
+    int num_out = ctx->num_out;
+
+    echoDecompositionInputs(ctx, g_file, f_file);
+
+    ParsedPLA f_on = {0}, g_on = {0}, h_minim = {0};
+    if ((parse(p->f_file, &(ctx->manager), &f_on, NULL, 0) == -1) ||
+        (parse(p->g_file, &(ctx->manager), &g_on, NULL, 0) == -1))
+    {
+        fprintf(stderr, "[!!] impossibile leggere %s e %s\n", p->f_file, p->g_file);
+        freeParsedPLA(manager, &f_on);
+        freeParsedPLA(manager, &g_on);
+        return -1;
+    }
+
+    DdNode **g_off = safe_malloc(num_out * sizeof(DdNode *));
+    DdNode **h_dc = safe_malloc(num_out * sizeof(DdNode *));
+
+    /* f_off[i] = !(f_on[i] U f_dc[i]) */
+    for (int i = 0; i < num_out; i++)
+    {
+        g_off[i] = Cudd_Not(g_on.vectorbdd_F[i]);
+        Cudd_Ref(g_off[i]);
+
+        h_dc[i] = Cudd_bddOr(manager, g_off[i], f_dc->vectorbdd_F[i]);
+        Cudd_Ref(h_dc[i]);
+    }
+
+    fflush(stdin);
+    int ret = mergeBDDtoFile(ctx, p->temp_h, f_on.vectorbdd_F, h_dc);
+
+    if (ret == 0)
+    {
+        char *sys_command;
+        asprintf(&sys_command, "espresso %s | sed -e '/\\.[p-type]/d' > %s", p->temp_h, p->out_h);
+        system(sys_command);
+        free(sys_command);
+
+        if (parse(p->out_h, &(ctx->manager), &h_minim, NULL, 1) == -1)
+        {
+            fprintf(stderr, "[!!] impossibile leggere %s\n", p->out_h);
+            ret = -1;
+        }
+    }
+
+    if (ret == 0)
+    {
+        pla_stats(&h_minim, &(ctx->h_stats));
+        ctx->h_stats.prod_in = h_minim.in_literals;
+
+        DdNode **and_out = safe_malloc(num_out * sizeof(DdNode *));
+
+        for (int i = 0; i < num_out; i++)
+        {
+            and_out[i] = Cudd_bddAnd(manager, g_on.vectorbdd_F[i], h_minim.vectorbdd_F[i]);
+            Cudd_Ref(and_out[i]);
+        }
+
+        ret = writeRecomposed(ctx, and_out);
+
+        for (int i = 0; i < num_out; i++)
+            Cudd_RecursiveDeref(manager, and_out[i]);
+        free(and_out);
+    }
+
+    /* pulizia */
+    for (int i = 0; i < num_out; i++)
+    {
+        Cudd_RecursiveDeref(manager, g_off[i]);
+        Cudd_RecursiveDeref(manager, h_dc[i]);
+    }
+
+    free(g_off);
+    free(h_dc);
+
+    freeParsedPLA(manager, &f_on);
+    freeParsedPLA(manager, &g_on);
+    freeParsedPLA(manager, &h_minim);
+
+    if (ret == -1)
+        return -1;
+
+    /* verifica di correttezza */
+    return verifyDecomposition(ctx, f_file);
+}
+
+/**
+ * @brief Minimizzazione di una PLA con espresso in un processo separato
+ *
+ * @param in la PLA
+ * @param out il file della copertura minimizzata
+ * @return pid_t il pid del processo, -1 se non può essere creato
+ */
+static pid_t spawnEspresso(const char *in, const char *out)
+{
+    char *command;
+
+    asprintf(&command, "espresso %s | sed -e '/\\.[p-type]/d' > %s", in, out);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        execl("/bin/sh", "sh", "-c", command, (char *)NULL);
+        _exit(127);
+    }
+    free(command);
+
+    if (pid == -1)
+        perror("[!!] fork");
+    return pid;
+}
+
+/* varianti di bestDecomposition, con h da minimizzare per AND e OR */
+enum
+{
+    VARIANT_AND,
+    VARIANT_OR,
+    N_VARIANTS,
+    VARIANT_NONE = N_VARIANTS /* funzione minimizzata, senza decomposizione */
+};
+
+/**
+ * @brief Decomposizione scelta per output tra f = g * h, con g la PLA euristica (che
+ *  approssima f per eccesso), e f = g_u + h, con g_u i prodotti di g contenuti in
+ *  On-set + DC-set di f (un'approssimazione per difetto). Le due funzioni h sono
+ *  costruite sulle stesse BDD e minimizzate da due espresso in parallelo; per ogni
+ *  output vince la variante con meno letterali AND, poi con meno porte OR, poi AND.
+ *  Un output per cui entrambe superano i letterali della funzione minimizzata non
+ *  viene decomposto, quindi il totale non supera quello della funzione minimizzata
+ *
+ * @param ctx il contesto
+ * @param f_dc il DC-set della funzione f
+ * @param g_file il file PLA della funzione g
+ * @param f_file il file PLA della funzione f
+ * @return int -1 se la decomposizione o la sua verifica fallisce, 0 altrimenti
+ */
+static int bestDecomposition(SopContext *ctx, ParsedPLA *f_dc, char *g_file, char *f_file)
+{
+    DdManager *manager = ctx->manager;
+    SopPaths *p = &(ctx->paths);
+    int num_in = ctx->num_in, num_out = ctx->num_out;
+    const char *temp_h[N_VARIANTS] = {p->temp_h, p->temp_h_or};
+    const char *out_h[N_VARIANTS] = {p->out_h, p->out_h_or};
+
+    echoDecompositionInputs(ctx, g_file, f_file);
+
+    ParsedPLA f_on = {0}, g_on = {0}, h_minim[N_VARIANTS] = {{0}};
+    if ((parse(p->f_file, &(ctx->manager), &f_on, NULL, 0) == -1) ||
+        (parse(p->g_file, &(ctx->manager), &g_on, NULL, 1) == -1))
+    {
+        fprintf(stderr, "[!!] impossibile leggere %s e %s\n", p->f_file, p->g_file);
+        freeParsedPLA(manager, &f_on);
+        freeParsedPLA(manager, &g_on);
+        return -1;
+    }
+
+    DdNode **h_on[N_VARIANTS], **h_dc[N_VARIANTS];
+    DdNode **g_under = safe_malloc(num_out * sizeof(DdNode *));
+    int *under_lit = safe_calloc(num_out, sizeof(int));
+    int *under_or = safe_calloc(num_out, sizeof(int));
+
+    for (int v = 0; v < N_VARIANTS; v++)
+    {
+        h_on[v] = safe_malloc(num_out * sizeof(DdNode *));
+        h_dc[v] = safe_malloc(num_out * sizeof(DdNode *));
+    }
+
+    for (int o = 0; o < num_out; o++)
+    {
+        DdNode *upper = Cudd_bddOr(manager, f_on.vectorbdd_F[o], f_dc->vectorbdd_F[o]);
+        Cudd_Ref(upper);
+
+        /* g_u: prodotti di g che non complementano mintermini */
+        g_under[o] = Cudd_ReadLogicZero(manager);
+        Cudd_Ref(g_under[o]);
+        for (int j = 0; j < g_on.cubes[o].len; j++)
+        {
+            if (!cube_alive(&g_on, o, j))
+                continue;
+
+            DdNode *prod = construct_product(manager, cube_at(&g_on, o, j), num_in);
+            if (Cudd_bddLeq(manager, prod, upper))
+            {
+                DdNode *tmp = Cudd_bddOr(manager, g_under[o], prod);
+                Cudd_Ref(tmp);
+                Cudd_RecursiveDeref(manager, g_under[o]);
+                g_under[o] = tmp;
+                under_lit[o] += cube_literals(cube_at(&g_on, o, j), num_in);
+                under_or[o]++;
+            }
+            Cudd_RecursiveDeref(manager, prod);
+        }
+        Cudd_RecursiveDeref(manager, upper);
+
+        /* AND: h = f dove g vale 1, indifferenza dove g vale 0 */
+        h_on[VARIANT_AND][o] = f_on.vectorbdd_F[o];
+        Cudd_Ref(h_on[VARIANT_AND][o]);
+        h_dc[VARIANT_AND][o] = Cudd_bddOr(manager, Cudd_Not(g_on.vectorbdd_F[o]), f_dc->vectorbdd_F[o]);
+        Cudd_Ref(h_dc[VARIANT_AND][o]);
+
+        /* OR: h = f dove g_u vale 0, indifferenza dove g_u vale 1 */
+        h_on[VARIANT_OR][o] = Cudd_bddAnd(manager, f_on.vectorbdd_F[o], Cudd_Not(g_under[o]));
+        Cudd_Ref(h_on[VARIANT_OR][o]);
+        h_dc[VARIANT_OR][o] = Cudd_bddOr(manager, g_under[o], f_dc->vectorbdd_F[o]);
+        Cudd_Ref(h_dc[VARIANT_OR][o]);
+    }
+
+    /* le due minimizzazioni sono indipendenti: espresso in parallelo */
+    pid_t pid[N_VARIANTS];
+    int ret = 0;
+    for (int v = 0; v < N_VARIANTS; v++)
+    {
+        pid[v] = -1;
+        if ((ret == 0) && (mergeBDDtoFile(ctx, (char *)temp_h[v], h_on[v], h_dc[v]) == 0))
+            pid[v] = spawnEspresso(temp_h[v], out_h[v]);
+        if (pid[v] == -1)
+            ret = -1;
+    }
+    for (int v = 0; v < N_VARIANTS; v++)
+    {
+        if (pid[v] == -1)
+            continue;
+        waitpid(pid[v], NULL, 0);
+        if ((ret == 0) && (parse((char *)out_h[v], &(ctx->manager), &(h_minim[v]), NULL, 1) == -1))
+        {
+            fprintf(stderr, "[!!] impossibile leggere %s\n", out_h[v]);
+            ret = -1;
+        }
+    }
+
+    if (ret == 0)
+    {
+        DdNode **recomposed = safe_malloc(num_out * sizeof(DdNode *));
+        int chosen[N_VARIANTS + 1] = {0};
+
+        memset(&(ctx->h_stats), 0, sizeof(struct test_stats));
+        memset(&(ctx->decomp_stats), 0, sizeof(struct test_stats));
+        for (int o = 0; o < num_out; o++)
+        {
+            int lit[N_VARIANTS], ports[N_VARIANTS];
+
+            lit[VARIANT_AND] = g_on.cubes[o].literals + h_minim[VARIANT_AND].cubes[o].literals;
+            ports[VARIANT_AND] = cube_count(&g_on, o) + cube_count(&(h_minim[VARIANT_AND]), o);
+            lit[VARIANT_OR] = under_lit[o] + h_minim[VARIANT_OR].cubes[o].literals;
+            ports[VARIANT_OR] = under_or[o] + cube_count(&(h_minim[VARIANT_OR]), o);
+
+            int v = ((lit[VARIANT_OR] < lit[VARIANT_AND]) ||
+                     ((lit[VARIANT_OR] == lit[VARIANT_AND]) && (ports[VARIANT_OR] < ports[VARIANT_AND])))
+                        ? VARIANT_OR
+                        : VARIANT_AND;
+
+            if ((ctx->output_stats != NULL) && (ctx->output_stats[o].and_lit < lit[v]))
+            {
+                chosen[VARIANT_NONE]++;
+                ctx->decomp_stats.and_lit += ctx->output_stats[o].and_lit;
+                ctx->decomp_stats.or_port += ctx->output_stats[o].or_port;
+                recomposed[o] = f_on.vectorbdd_F[o];
+                Cudd_Ref(recomposed[o]);
+                continue;
+            }
+
+            chosen[v]++;
+            ctx->decomp_stats.and_lit += lit[v];
+            ctx->decomp_stats.or_port += ports[v];
+            ctx->h_stats.and_lit += h_minim[v].cubes[o].literals;
+            ctx->h_stats.or_port += cube_count(&(h_minim[v]), o);
+
+            if (v == VARIANT_AND)
+                recomposed[o] = Cudd_bddAnd(manager, g_on.vectorbdd_F[o], h_minim[v].vectorbdd_F[o]);
+            else
+                recomposed[o] = Cudd_bddOr(manager, g_under[o], h_minim[v].vectorbdd_F[o]);
+            Cudd_Ref(recomposed[o]);
+        }
+        ret = writeRecomposed(ctx, recomposed);
+
+        if (ctx->output_mode == VERBOSE_LOG)
+            printf("*********************************\nDecomposizione per output: AND %d, OR %d, nessuna %d\n",
+                   chosen[VARIANT_AND], chosen[VARIANT_OR], chosen[VARIANT_NONE]);
+
+        for (int o = 0; o < num_out; o++)
+            Cudd_RecursiveDeref(manager, recomposed[o]);
+        free(recomposed);
+    }
+
+    /* pulizia */
+    for (int o = 0; o < num_out; o++)
+    {
+        Cudd_RecursiveDeref(manager, g_under[o]);
+        for (int v = 0; v < N_VARIANTS; v++)
+        {
+            Cudd_RecursiveDeref(manager, h_on[v][o]);
+            Cudd_RecursiveDeref(manager, h_dc[v][o]);
+        }
+    }
+    for (int v = 0; v < N_VARIANTS; v++)
+    {
+        free(h_on[v]);
+        free(h_dc[v]);
+        freeParsedPLA(manager, &(h_minim[v]));
+    }
+    free(g_under);
+    free(under_lit);
+    free(under_or);
+    freeParsedPLA(manager, &f_on);
+    freeParsedPLA(manager, &g_on);
+
+    if (ret == -1)
+        return -1;
+
+    return verifyDecomposition(ctx, f_file);
+}
+
+/**
+ * @brief Candidati di un output indicizzati per prodotto, per scartare le espansioni
+ *  ripetute al momento della generazione
+ */
+typedef struct CandidateSet
+{
+    PlaRows rows;      /* prodotti già generati */
+    product_t **cand;  /* candidato per riga di rows, NULL se il prodotto è stato scartato */
+    int size;          /* capacità di cand */
+} CandidateSet;
+
+static void candidateSetInit(CandidateSet *s, int num_in)
+{
+    /* le uscite delle righe non vengono usate */
+    pla_rows_init(&(s->rows), num_in, 1);
+    s->cand = NULL;
+    s->size = 0;
+}
+
+/**
+ * @brief Posizione del candidato associato a cube, NULL per un prodotto nuovo
+ *
+ * @param s l'insieme
+ * @param cube il prodotto
+ * @param copy se cube va copiato
+ * @param inserted impostato a 1 se il prodotto non era presente
+ * @return product_t** la posizione del candidato
+ */
+static product_t **candidateSetGet(CandidateSet *s, const int *cube, int copy, int *inserted)
+{
+    int len = s->rows.len;
+    int i = pla_rows_index(&(s->rows), cube, copy);
+
+    *inserted = (s->rows.len > len);
+    if (*inserted)
+    {
+        if (i == s->size)
+        {
+            s->size = s->size ? 2 * s->size : 64;
+            s->cand = safe_realloc(s->cand, s->size * sizeof(product_t *));
+        }
+        s->cand[i] = NULL;
+    }
+
+    return &(s->cand[i]);
+}
+
+static void candidateSetFree(CandidateSet *s)
+{
+    pla_rows_free(&(s->rows));
+    free(s->cand);
+    s->cand = NULL;
+}
+
+/**
+ * @brief Candidato della coda limitata: seq è la posizione di generazione
+ *  nell'output, a parità di priorità è peggiore il candidato generato dopo
+ */
+typedef struct BoundEntry
+{
+    double prio;
+    long long seq;
+    product_t *p;
+} BoundEntry;
+
+static int boundWorse(const BoundEntry *a, const BoundEntry *b)
+{
+    return (a->prio < b->prio) || ((a->prio == b->prio) && (a->seq > b->seq));
+}
+
+/**
+ * @brief Inserimento di e tra i k migliori candidati, in un min-heap con il peggiore
+ *  in testa. Con l'heap pieno e deve essere migliore della testa, che viene esclusa
+ *
+ * @param h l'heap, di capacità k
+ * @param len il numero di elementi
+ * @param k la capacità
+ * @param e il candidato
+ * @return product_t* il candidato escluso, NULL se l'heap non era pieno
+ */
+static product_t *boundInsert(BoundEntry *h, int *len, int k, BoundEntry e)
+{
+    product_t *evicted = NULL;
+    int i;
+
+    if (*len < k)
+    {
+        /* risalita */
+        for (i = (*len)++; (i > 0) && boundWorse(&e, &h[(i - 1) / 2]); i = (i - 1) / 2)
+            h[i] = h[(i - 1) / 2];
+        h[i] = e;
+        return NULL;
+    }
+
+    /* sostituzione della testa e discesa */
+    evicted = h[0].p;
+    for (i = 0; 2 * i + 1 < k;)
+    {
+        int c = 2 * i + 1;
+        if ((c + 1 < k) && boundWorse(&h[c + 1], &h[c]))
+            c++;
+        if (!boundWorse(&h[c], &e))
+            break;
+        h[i] = h[c];
+        i = c;
+    }
+    h[i] = e;
+    return evicted;
+}
+
+/**
+ * @brief Coda limitata (-B): per ogni output restano in coda i migliori k candidati,
+ *  gli altri vengono generati quando quelli dell'output sono esauriti
+ */
+typedef struct QueueBound
+{
+    int k;               /* candidati per output */
+    int *live;           /* candidati validi in coda per output */
+    int *accepted;       /* prodotti accettati per output */
+    int *gen_accepted;   /* accepted all'ultima generazione */
+    char *truncated;     /* output con candidati esclusi dal limite */
+    BoundEntry *cutoff;  /* peggior candidato conservato per output */
+} QueueBound;
+
+/**
+ * @brief Valutazione dei candidati generati da un intervallo di prodotti di un output
+ */
+typedef struct CandidateWorker
+{
+    SopContext *ctx;
+    ParsedPLA *pla;
+    DdManager *own;     /* manager privato del thread */
+    DdManager *manager; /* manager in uso: own, o quello del contesto */
+    DdNode *offset;     /* Off-set dell'output nel manager in uso */
+    int output;
+    int first, last;    /* prodotti [first, last) */
+    prior_queue found;  /* candidati nell'ordine di generazione, senza ordinamento */
+    Arena slab;         /* memoria dei candidati del thread, trasferita al contesto */
+    int k;              /* coda limitata: candidati conservati, 0 senza limite */
+    BoundEntry *best;   /* coda limitata: i migliori k candidati */
+    int n_best;
+    int from_cutoff;    /* coda limitata: solo i candidati peggiori di cutoff */
+    BoundEntry cutoff;
+    int truncated;      /* coda limitata: se sono stati esclusi candidati */
+} CandidateWorker;
+
+/**
+ * @brief Espansione parziale di un prodotto nella ricerca beam
+ */
+typedef struct BeamEntry
+{
+    double score; /* prodotti coperti su mintermini complementati */
+    int *cube;
+} BeamEntry;
+
+/**
+ * @brief Inserimento di un'espansione tra le migliori width del livello successivo;
+ *  a parità di rapporto resta quella generata prima
+ *
+ * @param beam le espansioni conservate, ognuna con spazio per num_in letterali
+ * @param len il numero di espansioni
+ * @param width l'ampiezza del beam
+ * @param score il rapporto dell'espansione
+ * @param cube il prodotto espanso
+ * @param num_in il numero di ingressi
+ */
+static void beamKeep(BeamEntry *beam, int *len, int width, double score, const int *cube, int num_in)
+{
+    int slot = *len;
+
+    if (*len == width)
+    {
+        slot = 0;
+        for (int i = 1; i < width; i++)
+            if (beam[i].score <= beam[slot].score)
+                slot = i;
+        if (score <= beam[slot].score)
+            return;
+    }
+    else
+        (*len)++;
+
+    beam[slot].score = score;
+    memcpy(beam[slot].cube, cube, num_in * sizeof(int));
+}
+
+static int hasOrigin(product_t *p, int origin)
+{
+    if (p->product_number == origin)
+        return 1;
+    for (int k = 0; k < p->n_origins; k++)
+        if (p->origins[k] == origin)
+            return 1;
+    return 0;
+}
+
+/**
+ * @brief Valutazione di un prodotto espanso: è un candidato se complementa al più ct
+ *  mintermini. Un prodotto già generato da un'altra espansione non viene rivalutato:
+ *  se era stato accettato, l'origine viene aggiunta al candidato esistente.
+ *  L'intersezione con l'Off-set viene conservata solo se calcolata nel manager del contesto
+ *
+ * @param w il CandidateWorker
+ * @param seen i prodotti già generati
+ * @param cube il prodotto espanso
+ * @param product_i il prodotto di origine
+ * @param seq la posizione di generazione nell'output
+ * @param expand se il prodotto può essere espanso ulteriormente (ricerca beam)
+ * @param score il rapporto tra prodotti coperti e mintermini complementati
+ * @return int 1 se il prodotto va considerato per l'espansione successiva, 0 altrimenti
+ */
+static int evaluateExpansion(CandidateWorker *w, CandidateSet *seen, int *cube, int product_i, long long seq,
+                             int expand, double *score)
+{
+    DdManager *manager = w->manager;
+    int num_in = w->ctx->num_in, o = w->output;
+    int keep_inters = (manager == w->ctx->manager);
+    int inserted, admit = 1;
+
+    product_t **prev = candidateSetGet(seen, cube, 1, &inserted);
+    if (!inserted)
+    {
+        if ((*prev != NULL) && !hasOrigin(*prev, product_i))
+            product_add_origin(&(w->slab), *prev, product_i);
+        return 0;
+    }
+
+    int counted = (w->k > 0) || expand;
+    int covered_prod = counted ? countCovered(w->pla, cube, o, num_in) : 0;
+    if (covered_prod < 0)
+        return 0;
+
+    if (w->k > 0)
+    {
+        /* la priorità non supera covered_prod: senza posto tra i migliori k la BDD del
+           prodotto non viene costruita, a meno che serva a proseguire l'espansione */
+        BoundEntry e = {covered_prod, seq, NULL};
+        if ((w->n_best == w->k) && !boundWorse(&(w->best[0]), &e))
+        {
+            w->truncated = 1;
+            if (!expand)
+                return 0;
+            admit = 0;
+        }
+    }
+
+    DdNode *curr_entry_node = construct_product(manager, cube, num_in);
+    DdNode *intersect = Cudd_bddAnd(manager, curr_entry_node, w->offset);
+    Cudd_Ref(intersect);
+    Cudd_RecursiveDeref(manager, curr_entry_node);
+    double complemented_minterms = Cudd_CountMinterm(manager, intersect, num_in);
+
+    /* i mintermini complementati non diminuiscono espandendo: il ramo viene potato */
+    if (complemented_minterms > w->ctx->ct)
+    {
+        Cudd_RecursiveDeref(manager, intersect);
+        return 0;
+    }
+    *score = (complemented_minterms > 0) ? covered_prod / complemented_minterms : HUGE_VAL;
+
+    if (complemented_minterms == 0) /* non complementa mintermini, non entra nella coda */
+        admit = 0;
+    else if (admit && !counted)
+        admit = ((covered_prod = countCovered(w->pla, cube, o, num_in)) >= 0);
+    else if (admit && (w->k > 0))
+    {
+        /* candidati già generati prima del taglio o peggiori dei migliori k */
+        BoundEntry e = {(double)covered_prod / complemented_minterms, seq, NULL};
+        if (w->from_cutoff && !boundWorse(&e, &(w->cutoff)))
+            admit = 0;
+        else if ((w->n_best == w->k) && !boundWorse(&(w->best[0]), &e))
+        {
+            w->truncated = 1;
+            admit = 0;
+        }
+    }
+
+    if (admit)
+    {
+        product_t *cube_queue = product_new(&(w->slab), num_in);
+        double priority = (double)covered_prod / complemented_minterms;
+        cube_queue->output_f = o;
+        cube_queue->compl_min = complemented_minterms;
+        cube_queue->covered_prod = covered_prod;
+        cube_queue->product_number = product_i;
+        cube_queue->valid = 1;
+        cube_queue->offset_inters = keep_inters ? intersect : NULL;
+        memcpy(cube_queue->cube, cube, num_in * sizeof(int));
+
+        append(&(w->found), priority, cube_queue);
+        *prev = cube_queue;
+
+        product_t *evicted = NULL;
+        if (w->k > 0)
+            evicted = boundInsert(w->best, &(w->n_best), w->k, (BoundEntry){priority, seq, cube_queue});
+        if (evicted != NULL)
+        {
+            /* resta in found fino all'accodamento, dove viene scartato */
+            w->truncated = 1;
+            evicted->valid = 0;
+            if (evicted->offset_inters != NULL)
+                Cudd_RecursiveDeref(manager, evicted->offset_inters);
+            evicted->offset_inters = NULL;
+        }
+    }
+
+    if (!admit || !keep_inters)
+        Cudd_RecursiveDeref(manager, intersect);
+
+    return expand;
+}
+
+/**
+ * @brief Generazione dei prodotti espansi di un intervallo: per ogni prodotto viene
+ *  rimosso un letterale alla volta. Con la ricerca beam si prosegue fino a beam_depth
+ *  letterali rimossi, espandendo a ogni livello solo le migliori beam_width espansioni
+ *  del prodotto per prodotti coperti su mintermini complementati; i rami che superano
+ *  ct mintermini complementati vengono potati
+ *
+ * @param arg il CandidateWorker
+ * @return void* NULL
+ */
+static void *evaluateCandidates(void *arg)
+{
+    CandidateWorker *w = arg;
+    ParsedPLA *pla = w->pla;
+    int num_in = w->ctx->num_in, o = w->output;
+    int width = (w->ctx->beam_width > 0) ? w->ctx->beam_width : 1;
+    int depth = (w->ctx->beam_width > 0) ? min(w->ctx->beam_depth, num_in) : 1;
+    /* espansioni generate al più da un prodotto, per numerarle nell'ordine di generazione */
+    long long per_cube = (long long)num_in * (1 + (long long)(depth - 1) * width);
+    int *cube_iterator = safe_malloc(num_in * sizeof(int));
+    int *cubes = safe_malloc(2 * (size_t)width * num_in * sizeof(int));
+    BeamEntry *frontier = safe_malloc(width * sizeof(BeamEntry));
+    BeamEntry *next = safe_malloc(width * sizeof(BeamEntry));
+    CandidateSet seen;
+
+    for (int b = 0; b < width; b++)
+    {
+        frontier[b].cube = cubes + (size_t)b * num_in;
+        next[b].cube = cubes + (size_t)(width + b) * num_in;
+    }
+
+    candidateSetInit(&seen, num_in);
+    for (int product_i = w->first; product_i < w->last; product_i++)
+    {
+        if (!cube_alive(pla, o, product_i))
+            continue;
+
+        SopProgress *progress = &(w->ctx->progress);
+        int found = w->found.len;
+        long long seq = (long long)product_i * per_cube;
+        int n_frontier = 1;
+        memcpy(frontier[0].cube, cube_at(pla, o, product_i), num_in * sizeof(int));
+
+        for (int level = 1; (level <= depth) && (n_frontier > 0); level++)
+        {
+            int n_next = 0, expand = (level < depth);
+
+            for (int b = 0; b < n_frontier; b++)
+            {
+                memcpy(cube_iterator, frontier[b].cube, num_in * sizeof(int));
+
+                for (int i = 0; i < num_in; i++)
+                {
+                    if ((cube_iterator[i] != 1) && (cube_iterator[i] != 0))
+                        continue;
+
+                    double score;
+                    int dump = cube_iterator[i];
+                    cube_iterator[i] = 2;
+                    if (evaluateExpansion(w, &seen, cube_iterator, product_i, seq++, expand, &score))
+                        beamKeep(next, &n_next, width, score, cube_iterator, num_in);
+                    cube_iterator[i] = dump; /* ripristina cubo originale */
+                }
+            }
+
+            BeamEntry *tmp = frontier;
+            frontier = next;
+            next = tmp;
+            n_frontier = n_next;
+        }
+
+        progress_add(progress, &(progress->cubes_done), 1);
+        progress_add(progress, &(progress->generated), w->found.len - found);
+    }
+
+    candidateSetFree(&seen);
+    free(frontier);
+    free(next);
+    free(cubes);
+    free(cube_iterator);
+    return NULL;
+}
+
+/**
+ * @brief Unione di un candidato di un blocco con quelli dei blocchi precedenti
+ *
+ * @param a l'arena dei candidati
+ * @param merged i candidati dei blocchi precedenti
+ * @param p il candidato
+ * @return int 1 se il prodotto è nuovo, 0 se è stato unito a uno esistente e scartato
+ */
+static int mergeCandidate(Arena *a, CandidateSet *merged, product_t *p)
+{
+    int inserted;
+    product_t **prev = candidateSetGet(merged, p->cube, 0, &inserted);
+
+    if (inserted)
+    {
+        *prev = p;
+        return 1;
+    }
+
+    product_add_origin(a, *prev, p->product_number);
+    for (int k = 0; k < p->n_origins; k++)
+        product_add_origin(a, *prev, p->origins[k]);
+    return 0;
+}
+
+/**
+ * @brief Pubblicazione della lunghezza della coda e dei nodi vivi nel file di avanzamento
+ */
+static void publishQueue(SopContext *ctx, prior_queue *queue)
+{
+    SopProgress *p = &(ctx->progress);
+
+    if (!p->active)
+        return;
+    progress_set(p, &(p->queue_len), queue->len);
+    progress_set(p, &(p->nodes), (int64_t)Cudd_ReadKeys(ctx->manager) - Cudd_ReadDead(ctx->manager));
+}
+
+static int compareSeq(const void *a, const void *b)
+{
+    long long sa = ((const BoundEntry *)a)->seq, sb = ((const BoundEntry *)b)->seq;
+    return (sa > sb) - (sa < sb);
+}
+
+/**
+ * @brief Accodamento di un candidato: senza ordinamento se l'heap verrà costruito alla
+ *  fine della generazione, altrimenti con la risalita nell'heap già ordinato
+ */
+static void enqueue(prior_queue *queue, double priority, product_t *p, int bulk)
+{
+    if (bulk)
+        append(queue, priority, p);
+    else
+        push(queue, priority, p);
+}
+
+/**
+ * @brief Generazione dei prodotti espansi degli output [first, last). Con più thread i
+ *  prodotti di ogni output vengono divisi in blocchi contigui, valutati in manager
+ *  separati che contengono una copia dell'Off-set; i candidati sono accodati
+ *  nell'ordine dei blocchi, quindi la coda è identica a quella sequenziale.
+ *  Con la coda limitata ogni blocco conserva i suoi migliori k candidati e l'output
+ *  i migliori k tra quelli dei blocchi. Su una coda vuota l'heap è costruito alla
+ *  fine in O(n); la rigenerazione di un output durante l'estrazione inserisce i suoi
+ *  candidati uno alla volta, senza riordinare tutta la coda
+ *
+ * @param ctx il contesto
+ * @param pla la funzione originale
+ * @param offset l'Off-set della funzione
+ * @param queue la coda dei candidati
+ * @param bound la coda limitata, NULL se disattivata
+ * @param first il primo output
+ * @param last l'output successivo all'ultimo
+ */
+static void generateCandidates(SopContext *ctx, ParsedPLA *pla, DdNode **offset, prior_queue *queue,
+                               QueueBound *bound, int first, int last)
+{
+    int k = (bound != NULL) ? bound->k : 0;
+    int n_threads = (ctx->threads > 1) ? ctx->threads : 1;
+    CandidateWorker *w = safe_calloc(n_threads, sizeof(CandidateWorker));
+    pthread_t *tid = safe_malloc(n_threads * sizeof(pthread_t));
+    int *started = safe_malloc(n_threads * sizeof(int));
+
+    for (int t = 0; t < n_threads; t++)
+    {
+        w[t].ctx = ctx;
+        w[t].pla = pla;
+        w[t].own = (n_threads == 1) ? NULL : Cudd_Init(0, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+        queue_init(&(w[t].found), INIT_SIZE);
+        arena_init(&(w[t].slab), 0);
+        w[t].k = k;
+        w[t].best = (k > 0) ? safe_malloc(k * sizeof(BoundEntry)) : NULL;
+    }
+    BoundEntry *best = (k > 0) ? safe_malloc(k * sizeof(BoundEntry)) : NULL;
+
+    /* generazione iniziale, o coda esaurita: i candidati vengono accodati senza ordinamento
+       e l'heap è costruito una sola volta */
+    int bulk = (queue->len == 0);
+    for (int o = first; o < last; o++)
+    {
+        IncrOutput *prev = (ctx->incr.prev != NULL) ? &(ctx->incr.prev[o]) : NULL;
+
+        if ((prev != NULL) && prev->reuse)
+        {
+            /* output invariato: in GLOBAL si riusano i candidati, in MULTIPLE direttamente il risultato */
+            if (ctx->error_mode == GLOBAL_OUTPUT_ERROR)
+                for (int i = 0; i < prev->n_cand; i++)
+                {
+                    enqueue(queue, prev->prio[i], prev->cand[i], bulk);
+                    prev->cand[i] = NULL;
+                }
+            continue;
+        }
+
+        int len = pla->cubes[o].len;
+        progress_add(&(ctx->progress), &(ctx->progress.cubes_total), cube_count(pla, o));
+        /* con pochi prodotti un blocco solo, valutato nel manager del contesto */
+        int n = (len >= 2 * n_threads) ? n_threads : 1;
+
+        for (int t = 0; t < n; t++)
+        {
+            w[t].output = o;
+            w[t].first = (int)((long long)len * t / n);
+            w[t].last = (int)((long long)len * (t + 1) / n);
+            w[t].found.len = w[t].found.n_data = 0;
+            w[t].n_best = w[t].truncated = 0;
+            if (k > 0)
+            {
+                /* senza accettazioni dall'ultima generazione i candidati non cambiano:
+                   si riparte da quelli successivi al taglio */
+                w[t].from_cutoff = bound->truncated[o] && (bound->accepted[o] == bound->gen_accepted[o]);
+                w[t].cutoff = bound->cutoff[o];
+            }
+            w[t].manager = (n == 1) ? ctx->manager : w[t].own;
+
+            /* il trasferimento legge il manager del contesto, quindi avviene qui */
+            if (w[t].manager == ctx->manager)
+                w[t].offset = offset[o];
+            else
+            {
+                w[t].offset = Cudd_bddTransfer(ctx->manager, w[t].manager, offset[o]);
+                Cudd_Ref(w[t].offset);
+            }
+        }
+
+        if (n == 1)
+            evaluateCandidates(&(w[0]));
+        else
+        {
+            /* un blocco senza thread viene valutato qui, nel suo manager: il risultato non cambia */
+            for (int t = 0; t < n; t++)
+            {
+                started[t] = (pthread_create(&(tid[t]), NULL, evaluateCandidates, &(w[t])) == 0);
+                if (!started[t])
+                    evaluateCandidates(&(w[t]));
+            }
+            for (int t = 0; t < n; t++)
+                if (started[t])
+                    pthread_join(tid[t], NULL);
+        }
+
+        /* un prodotto generato in più blocchi resta nel primo, con le origini degli altri */
+        CandidateSet merged;
+        prior_queue pending;
+        int n_best = 0, truncated = 0, live = 0;
+        if (n > 1)
+        {
+            candidateSetInit(&merged, ctx->num_in);
+            queue_init(&pending, INIT_SIZE);
+        }
+
+        for (int t = 0; t < n; t++)
+        {
+            truncated |= w[t].truncated;
+            for (int i = 0; i < w[t].found.len; i++)
+            {
+                product_t *p = queue_at(&(w[t].found), i);
+
+                if (!p->valid)
+                    continue; /* escluso dal limite del blocco */
+                if (n == 1)
+                {
+                    enqueue(queue, w[t].found.prio[i], p, bulk);
+                    live++;
+                }
+                else if ((k == 0) && mergeCandidate(&(ctx->candidates), &merged, p))
+                    append(&pending, w[t].found.prio[i], p);
+            }
+
+            if ((n == 1) && (k > 0))
+            {
+                n_best = w[0].n_best;
+                memcpy(best, w[0].best, n_best * sizeof(BoundEntry));
+            }
+            else if (k > 0)
+            {
+                /* i candidati conservati dal blocco, nell'ordine di generazione */
+                qsort(w[t].best, w[t].n_best, sizeof(BoundEntry), compareSeq);
+                for (int i = 0; i < w[t].n_best; i++)
+                {
+                    product_t *p = w[t].best[i].p;
+                    if (mergeCandidate(&(ctx->candidates), &merged, p))
+                    {
+                        append(&pending, w[t].best[i].prio, p);
+                        product_t *evicted = boundInsert(best, &n_best, k, w[t].best[i]);
+                        if (evicted != NULL)
+                        {
+                            evicted->valid = 0;
+                            truncated = 1;
+                        }
+                    }
+                }
+            }
+
+            if (w[t].manager != ctx->manager)
+                Cudd_RecursiveDeref(w[t].manager, w[t].offset);
+        }
+
+        if (n > 1)
+        {
+            for (int i = 0; i < pending.len; i++)
+            {
+                product_t *p = queue_at(&pending, i);
+
+                /* i candidati esclusi dal limite tra i blocchi restano nell'arena */
+                if (p->valid)
+                {
+                    enqueue(queue, pending.prio[i], p, bulk);
+                    live++;
+                }
+            }
+            candidateSetFree(&merged);
+            queue_free(&pending);
+        }
+
+        if (k > 0)
+        {
+            bound->live[o] = live;
+            bound->truncated[o] = truncated;
+            bound->gen_accepted[o] = bound->accepted[o];
+            if (truncated)
+                bound->cutoff[o] = best[0];
+        }
+        publishQueue(ctx, queue);
+    }
+
+    for (int t = 0; t < n_threads; t++)
+    {
+        if (w[t].own != NULL)
+            Cudd_Quit(w[t].own);
+        queue_free(&(w[t].found));
+        arena_merge(&(ctx->candidates), &(w[t].slab));
+        free(w[t].best);
+    }
+    free(best);
+    free(w);
+    free(tid);
+    free(started);
+
+    if (bulk)
+        heapify(queue);
+}
+
+/**
+ * @brief Sostituzione dei prodotti degli output riutilizzabili con il risultato
+ *  dell'estrazione salvato nella base incrementale (solo in MULTIPLE)
+ *
+ * @param ctx il contesto
+ * @param pla la funzione originale
+ * @param current_errors l'errore per output
+ * @param dcset_error i mintermini del DC-set coperti
+ * @return unsigned long long l'errore degli output riutilizzati
+ */
+static unsigned long long applyPrevious(SopContext *ctx, ParsedPLA *pla, unsigned long long *current_errors, int *dcset_error)
+{
+    unsigned long long error = 0;
+
+    for (int o = 0; o < ctx->num_out; o++)
+    {
+        IncrOutput *prev = &(ctx->incr.prev[o]);
+
+        if (!prev->reuse)
+            continue;
+
+        for (int i = 0; i < pla->cubes[o].len; i++)
+            if (cube_alive(pla, o, i))
+                cube_remove(pla, o, i);
+        cube_compact(pla, o);
+        for (int i = 0; i < prev->n_res; i++)
+            cube_append(pla, o, prev->res + (size_t)i * ctx->num_in);
+
+        current_errors[o] = prev->error;
+        error += prev->error;
+        *dcset_error += prev->dc_error;
+        if (ctx->incr.dc_error != NULL)
+            ctx->incr.dc_error[o] = prev->dc_error;
+    }
+
+    return error;
+}
+
+/**
+ * @brief Coda limitata per la funzione pla: ogni prodotto accettato con errore consuma
+ *  almeno un mintermine, quindi un output accetta al più ct prodotti; k è il doppio, per
+ *  i candidati scartati all'estrazione, e non supera i candidati possibili di un output
+ *
+ * @param ctx il contesto
+ * @param pla la funzione originale
+ * @return QueueBound* la coda limitata
+ */
+static QueueBound *initBound(SopContext *ctx, ParsedPLA *pla)
+{
+    QueueBound *b = safe_malloc(sizeof(QueueBound));
+    unsigned long long k = 2 * ctx->ct + BOUND_MIN_K, max_cand = 1, per_cube = ctx->num_in;
+
+    /* la ricerca beam espande al più beam_width prodotti per livello oltre il primo */
+    if (ctx->beam_width > 0)
+        per_cube *= 1 + (unsigned long long)(min(ctx->beam_depth, ctx->num_in) - 1) * ctx->beam_width;
+    for (int o = 0; o < ctx->num_out; o++)
+        max_cand = max(max_cand, (unsigned long long)pla->cubes[o].len * per_cube);
+    b->k = (int)min(k, max_cand);
+
+    b->live = safe_calloc(ctx->num_out, sizeof(int));
+    b->accepted = safe_calloc(ctx->num_out, sizeof(int));
+    b->gen_accepted = safe_calloc(ctx->num_out, sizeof(int));
+    b->truncated = safe_calloc(ctx->num_out, sizeof(char));
+    b->cutoff = safe_calloc(ctx->num_out, sizeof(BoundEntry));
+
+    return b;
+}
+
+/**
+ * @brief Rilascio dell'intersezione con l'Off-set di un candidato uscito dalla coda:
+ *  la memoria del candidato resta nell'arena fino alla fine dell'euristica
+ */
+static void dropCandidate(DdManager *manager, product_t *p)
+{
+    if (p->offset_inters != NULL)
+        Cudd_RecursiveDeref(manager, p->offset_inters);
+    p->offset_inters = NULL;
+}
+
+/**
+ * @brief Capacità iniziale della coda: un candidato per letterale di ogni prodotto,
+ *  moltiplicato per i livelli della ricerca beam, al più k per output con la coda
+ *  limitata e non oltre QUEUE_PRESIZE_MAX
+ *
+ * @param ctx il contesto
+ * @param pla la funzione originale
+ * @param bound la coda limitata, NULL se disattivata
+ * @return int la capacità
+ */
+static int expectedCandidates(SopContext *ctx, ParsedPLA *pla, QueueBound *bound)
+{
+    unsigned long long n = 0, per_literal = 1;
+
+    if (ctx->beam_width > 0)
+        per_literal += (unsigned long long)(min(ctx->beam_depth, ctx->num_in) - 1) * ctx->beam_width;
+    for (int o = 0; o < ctx->num_out; o++)
+    {
+        unsigned long long cand = (unsigned long long)pla->cubes[o].literals * per_literal;
+        n += (bound != NULL) ? min(cand, (unsigned long long)bound->k) : cand;
+    }
+
+    return (int)min(n, (unsigned long long)QUEUE_PRESIZE_MAX);
+}
+
+static void freeBound(QueueBound *b)
+{
+    if (b == NULL)
+        return;
+
+    free(b->live);
+    free(b->accepted);
+    free(b->gen_accepted);
+    free(b->truncated);
+    free(b->cutoff);
+    free(b);
+}
+
+/**
+ * @brief Rilascio dei candidati rimasti in coda e della coda, poi di tutti i prodotti
+ *  espansi in un solo passo
+ */
+static void releaseCandidates(SopContext *ctx, prior_queue *queue)
+{
+    for (int i = 0; i < queue->len; i++)
+        dropCandidate(ctx->manager, queue_at(queue, i));
+    queue_free(queue);
+    free(queue);
+    arena_free(&(ctx->candidates));
+}
+
+/**
+ * @brief Euristica di sintesi logica approssimata mediante espansione assistita.
+ *
+ * @param ctx il contesto
+ * @param pla la funzione originale
+ * @param offset l'Off-set della funzione
+ * @param dontPla il DC-set della funzione
+ * @param s dati di test
+ * @param cpu_time il tempo di calcolo
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int heuristic(SopContext *ctx, ParsedPLA *pla, DdNode **offset, ParsedPLA *dontPla, struct test_stats *s,
+                     double *cpu_time)
+{
+    DdManager *manager = ctx->manager;
+    int num_in = ctx->num_in, num_out = ctx->num_out;
+    unsigned long long ct = ctx->ct;
+    clock_t beginClock = clock(), endClock;
+
+    prior_queue *queue;
+    unsigned long long *current_errors;
+    unsigned long long total_error = 0;
+    int added_product = 0, dcset_error = 0;
+    product_t *curr_prod;
+    /* CELF: prodotti accettati per output, per riconoscere le priorità non aggiornate */
+    int *accepted = ctx->lazy ? safe_calloc(num_out, sizeof(int)) : NULL;
+    QueueBound *bound = ctx->bounded ? initBound(ctx, pla) : NULL;
+    SopProgress *progress = &(ctx->progress);
+
+    /* in streaming gli errori sono dimensionati su tutti gli output da streamHeuristic */
+    if (ctx->stream == 0)
+        progress_outputs(progress, num_out);
+
+    if (ctx->ckpt.resumed != NULL)
+    {
+        /* ripresa da checkpoint: le intersezioni con l'Off-set vengono calcolate all'estrazione */
+        SopSearchState *st = ctx->ckpt.resumed;
+
+        queue = st->queue;
+        current_errors = st->current_errors;
+        total_error = st->total_error;
+        added_product = st->added_product;
+        dcset_error = st->dcset_error;
+        free(st);
+        ctx->ckpt.resumed = NULL;
+    }
+    else
+    {
+        queue = safe_malloc(sizeof(prior_queue));
+        queue_init(queue, expectedCandidates(ctx, pla, bound));
+        current_errors = safe_calloc(num_out, sizeof(unsigned long long));
+
+        int reused = (ctx->incr.base_dir != NULL) ? incr_load(ctx) : -1;
+        if ((ctx->output_mode == VERBOSE_LOG) && (reused >= 0))
+            printf("Output riutilizzati dalla sintesi precedente: %d/%d%s\n", reused, num_out,
+                   (ctx->error_mode == GLOBAL_OUTPUT_ERROR) ? " (solo candidati, estrazione completa)" : "");
+
+        ddstats_begin(ctx, PHASE_CANDIDATES);
+        generateCandidates(ctx, pla, offset, queue, bound, 0, num_out);
+        ddstats_end(ctx, PHASE_CANDIDATES);
+
+        if (ctx->ckpt.dir != NULL)
+        {
+            ckpt_save(ctx, &(SopSearchState){queue, current_errors, total_error, added_product, dcset_error});
+            incr_capture(ctx, queue);
+        }
+
+        if ((reused > 0) && (ctx->error_mode == MULTIPLE_OUTPUT_ERROR))
+            total_error = applyPrevious(ctx, pla, current_errors, &dcset_error);
+    }
+
+    /* stato ripreso da checkpoint o da output riutilizzati */
+    progress_add(progress, &(progress->accepted), added_product);
+    progress_add(progress, &(progress->total_error), total_error);
+    for (int o = 0; o < num_out; o++)
+        progress_error(progress, o, current_errors[o]);
+
+    if (ctx->output_mode == VERBOSE_LOG)
+    {
+        printf("**********************************\n");
+        if (ctx->error_mode == GLOBAL_OUTPUT_ERROR)
+            printf("Errore ammesso: max %lli mintermini sommati su tutti i %d output\n", ct, num_out);
+        else
+            printf("Errore ammesso: max %lli mintermini per ognuno dei %d output\n", ct, num_out);
+        printf("r = %g, NUM_IN = %d\n", ctx->r, num_in);
+
+        printf("****************************\n");
+        printf("Lunghezza coda prodotti eleggibili: %d\n", queue->len);
+    }
+
+    /* inizio estrazione coda */
+    ddstats_begin(ctx, PHASE_EXTRACTION);
+
+    SopTrace *trace = &(ctx->trace);
+    if (trace->path != NULL)
+        trace_open(trace, &(SopTraceHeader){.num_in = num_in, .num_out = num_out, .error_mode = ctx->error_mode,
+                                            .lazy = ctx->lazy, .ct = ct});
+
+    int last_o = -1, regenerated = 0, failed = 0;
+    while (1)
+    {
+        /* coda limitata: l'ultimo output estratto ha esaurito i candidati conservati */
+        if ((bound != NULL) && (last_o >= 0) && (bound->live[last_o] == 0) && bound->truncated[last_o])
+        {
+            generateCandidates(ctx, pla, offset, queue, bound, last_o, last_o + 1);
+            regenerated++;
+        }
+        last_o = -1;
+
+        if (queue->len == 0)
+            break;
+
+        if ((ctx->error_mode == GLOBAL_OUTPUT_ERROR) && (total_error >= ct))
+        {
+            trace_emit(trace, TRACE_STOP, 0, 0, queue->len, 0, 0);
+            break;
+        }
+
+        double top = queue->prio[0];
+        curr_prod = pop(queue);
+        publishQueue(ctx, queue);
+
+        if (curr_prod == NULL)
+            continue;
+
+        trace_emit(trace, TRACE_POP, curr_prod->output_f, curr_prod->product_number, 0, 0, top);
+        if (curr_prod->valid == 0)
+        {
+            trace_emit(trace, TRACE_INVALID, curr_prod->output_f, curr_prod->product_number, 0, 0, 0);
+            dropCandidate(manager, curr_prod);
+            continue;
+        }
+        if (bound != NULL)
+        {
+            last_o = curr_prod->output_f;
+            bound->live[last_o]--;
+        }
+
+        if ((accepted != NULL) && (curr_prod->epoch != accepted[curr_prod->output_f]))
+        {
+            /* priorità calcolata prima delle ultime accettazioni sull'output: la copertura
+               viene ricalcolata e il prodotto torna in coda se non è più il migliore */
+            int covered = countCovered(pla, curr_prod->cube, curr_prod->output_f, num_in);
+            if (covered < 0)
+            {
+                trace_emit(trace, TRACE_INVALID, curr_prod->output_f, curr_prod->product_number, 0, 0, 0);
+                dropCandidate(manager, curr_prod);
+                continue;
+            }
+
+            double priority = (double)covered / curr_prod->compl_min;
+            curr_prod->covered_prod = covered;
+            curr_prod->epoch = accepted[curr_prod->output_f];
+            if ((queue->len > 0) && (priority < queue->prio[0]))
+            {
+                trace_emit(trace, TRACE_RESCORE, curr_prod->output_f, curr_prod->product_number, 0, 0, priority);
+                reinsert(queue, priority);
+                if (bound != NULL)
+                    bound->live[last_o]++;
+                continue;
+            }
+        }
+
+        if (curr_prod->offset_inters == NULL)
+        {
+            /* candidato valutato in un altro manager o ripreso da un checkpoint */
+            DdNode *prod = construct_product(manager, curr_prod->cube, num_in);
+            curr_prod->offset_inters = Cudd_bddAnd(manager, prod, offset[curr_prod->output_f]);
+            Cudd_Ref(curr_prod->offset_inters);
+            Cudd_RecursiveDeref(manager, prod);
+        }
+
+        DdNode *dcset_intersect = Cudd_bddAnd(manager, curr_prod->offset_inters, dontPla->vectorbdd_F[curr_prod->output_f]);
+        Cudd_Ref(dcset_intersect);
+        double dcset_minterms = Cudd_CountMinterm(manager, dcset_intersect, num_in);
+        double effective_minterms = curr_prod->compl_min - dcset_minterms;
+
+        if (effective_minterms < 0)
+        {
+            fprintf(stderr, "[!!] errore inatteso: COMPL %g, DCSET %g\n", curr_prod->compl_min, dcset_minterms);
+            Cudd_RecursiveDeref(manager, dcset_intersect);
+            dropCandidate(manager, curr_prod);
+            failed = 1;
+            break;
+        }
+
+        Cudd_RecursiveDeref(manager, dcset_intersect);
+
+        if ((ctx->error_mode == MULTIPLE_OUTPUT_ERROR && (effective_minterms + current_errors[curr_prod->output_f] > ct)) ||
+            (ctx->error_mode == GLOBAL_OUTPUT_ERROR && (total_error + effective_minterms > ct)))
+        {
+            /* selezione greedy, toglilo dalla coda e continua */
+            trace_emit(trace, TRACE_OVER_BUDGET, curr_prod->output_f, curr_prod->product_number, 0, 0, effective_minterms);
+            dropCandidate(manager, curr_prod);
+            continue;
+        }
+
+        dcset_error += dcset_minterms;
+        if (ctx->incr.dc_error != NULL)
+            ctx->incr.dc_error[curr_prod->output_f] += dcset_minterms;
+        current_errors[curr_prod->output_f] += effective_minterms;
+        total_error += effective_minterms;
+        progress_add(progress, &(progress->accepted), 1);
+        progress_add(progress, &(progress->total_error), effective_minterms);
+        progress_error(progress, curr_prod->output_f, current_errors[curr_prod->output_f]);
+
+        added_product++;
+        if (accepted != NULL)
+            accepted[curr_prod->output_f]++;
+
+        int invalidated = invalidateRedundantInQueue(curr_prod, queue, num_in);
+        int removed = removeCoveredProducts(ctx, curr_prod, pla);
+        if (bound != NULL)
+        {
+            bound->live[last_o] -= invalidated;
+            bound->accepted[last_o]++;
+        }
+        trace_emit(trace, TRACE_ACCEPT, curr_prod->output_f, curr_prod->product_number, invalidated, removed,
+                   effective_minterms);
+
+#ifdef DEBUG
+        printf("Scelto prodotto con m_compl = %g, covered = %d *** Ct_%d = %llu\n", effective_minterms,
+               curr_prod->covered_prod, curr_prod->output_f, current_errors[curr_prod->output_f]);
+        print_cube(curr_prod->cube, num_in);
+        printf("Invalidati: %d, rimossi: %d, lunghezza coda: %d\n", invalidated, removed, queue->len);
+#endif
+
+        cube_append(pla, curr_prod->output_f, curr_prod->cube);
+        dropCandidate(manager, curr_prod);
+
+        if ((ctx->ckpt.dir != NULL) && (ctx->ckpt.every > 0) && (added_product % ctx->ckpt.every == 0))
+            ckpt_save(ctx, &(SopSearchState){queue, current_errors, total_error, added_product, dcset_error});
+    }
+    trace_close(trace);
+    ddstats_end(ctx, PHASE_EXTRACTION);
+
+    if (failed)
+    {
+        incr_free(ctx);
+        free(current_errors);
+        free(accepted);
+        freeBound(bound);
+        releaseCandidates(ctx, queue);
+        return -1;
+    }
+
+    if (ctx->output_mode == VERBOSE_LOG)
+    {
+        printf("Prodotti aggiunti: %d\n", added_product);
+        if (bound != NULL)
+            printf("Coda limitata: %d candidati per output, %d rigenerazioni\n", bound->k, regenerated);
+        printf("********************************\n");
+        printf("Errore totale computato: %lli\n", total_error);
+        printf("Errore DC-set: %d\n", dcset_error);
+        printf("Errore per output: ");
+        for (int i = 0; i < (num_out - 1); i++)
+            printf("%lli, ", current_errors[i]);
+        printf("%lli", current_errors[(num_out - 1)]);
+        printf("\n");
+
+        struct test_stats temp;
+        printf("\nDopo euristica -> ");
+        pla_stats(pla, &temp);
+        print_verbose_stats(temp);
+
+        /* PLA con ridondanze per la verifica finale con espresso */
+        mergeToPLA(ctx, pla, ctx->paths.out);
+    }
+
+    /* base per la sintesi incrementale successiva, prima della rimozione delle ridondanze */
+    if (ctx->incr.text != NULL)
+        incr_save(ctx, current_errors);
+    incr_free(ctx);
+
+    free(current_errors);
+    free(accepted);
+    freeBound(bound);
+
+    /**
+     * @brief rimozione dei prodotti coperti dall'OR di tutti i prodotti della funzione
+     *        eccetto lo stesso
+     */
+    ddstats_begin(ctx, PHASE_REDUNDANCY);
+    for (int o = 0; o < num_out; o++)
+    {
+        for (int outer = 0; outer < pla->cubes[o].len; outer++)
+        {
+            if (!cube_alive(pla, o, outer))
+                continue;
+
+            DdNode *single_prod = construct_product(manager, cube_at(pla, o, outer), num_in);
+            DdNode *foo_or = Cudd_ReadLogicZero(manager);
+            Cudd_Ref(foo_or);
+
+            for (int inner = 0; inner < pla->cubes[o].len; inner++)
+            {
+                if (cube_alive(pla, o, inner) && (outer != inner))
+                {
+                    DdNode *curr_node = construct_product(manager, cube_at(pla, o, inner), num_in);
+                    DdNode *tmp = Cudd_bddOr(manager, foo_or, curr_node);
+                    Cudd_Ref(tmp);
+                    Cudd_RecursiveDeref(manager, foo_or);
+                    Cudd_RecursiveDeref(manager, curr_node);
+                    foo_or = tmp;
+                }
+            }
+
+            /* il prodotto singolo è coperto dall'or, possiamo toglierlo */
+            if (Cudd_bddLeq(manager, single_prod, foo_or))
+                cube_remove(pla, o, outer);
+
+            Cudd_RecursiveDeref(manager, single_prod);
+            Cudd_RecursiveDeref(manager, foo_or);
+        }
+        cube_compact(pla, o);
+    }
+
+    ddstats_end(ctx, PHASE_REDUNDANCY);
+
+    pla_stats(pla, s);
+    if (ctx->output_mode == VERBOSE_LOG)
+    {
+        printf("Dopo euristica e rimozione ridondanze -> ");
+        print_verbose_stats(*s);
+    }
+
+    releaseCandidates(ctx, queue);
+
+    endClock = clock();
+    *cpu_time = (double)(endClock - beginClock) / CLOCKS_PER_SEC;
+
+    return 0;
+}
+
+/**
+ * @brief Creazione di una directory, e delle directory intermedie, se non esiste
+ *
+ * @param dir la directory
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int ensureDir(const char *dir)
+{
+    struct stat st = {0};
+    char *path = strdup(dir);
+
+    for (char *c = path + 1; ; c++)
+    {
+        if ((*c != '/') && (*c != '\0'))
+            continue;
+
+        char saved = *c;
+        *c = '\0';
+        if ((stat(path, &st) == -1) && (mkdir(path, 0700) == -1) && (errno != EEXIST))
+        {
+            fprintf(stderr, "Impossibile creare la cartella %s : ", path);
+            perror("");
+            free(path);
+            return -1;
+        }
+        *c = saved;
+
+        if ((saved == '\0') || (c[1] == '\0'))
+            break;
+    }
+
+    free(path);
+    return 0;
+}
+
+/**
+ * @brief Rilascio dei percorsi dei file di un contesto
+ *
+ * @param p i percorsi
+ */
+static void freePaths(SopPaths *p)
+{
+    free(p->minim);
+    free(p->minimized_out);
+    free(p->espresso_out);
+    free(p->out);
+    free(p->best);
+    free(p->g_file);
+    free(p->f_file);
+    free(p->temp_h);
+    free(p->g_times_h);
+    free(p->out_h);
+    free(p->temp_h_or);
+    free(p->out_h_or);
+}
+
+void sop_init(SopContext *ctx)
+{
+    memset(ctx, 0, sizeof(SopContext));
+    ctx->error_mode = MULTIPLE_OUTPUT_ERROR;
+    ctx->output_mode = VERBOSE_LOG;
+    ctx->ct = DEFAULT_CT;
+    ctx->threads = 1;
+    ctx->beam_depth = DEFAULT_BEAM_DEPTH;
+    arena_init(&(ctx->candidates), 0);
+
+    sop_set_workspace(ctx, TEMP_DIR, OUTPUT_DIR);
+    sop_set_cache(ctx, CACHE_DIR);
+}
+
+/**
+ * @brief Rimozione della directory temporanea riservata al contesto, se presente
+ *
+ * @param ctx il contesto
+ */
+static void removePrivateTemp(SopContext *ctx)
+{
+    if (!ctx->private_temp)
+        return;
+
+    /* la directory contiene solo file */
+    DIR *d = opendir(ctx->temp_dir);
+    if (d != NULL)
+    {
+        struct dirent *e;
+        while ((e = readdir(d)) != NULL)
+        {
+            if ((strcmp(e->d_name, ".") == 0) || (strcmp(e->d_name, "..") == 0))
+                continue;
+
+            char *file;
+            asprintf(&file, "%s%s", ctx->temp_dir, e->d_name);
+            unlink(file);
+            free(file);
+        }
+        closedir(d);
+    }
+    rmdir(ctx->temp_dir);
+    ctx->private_temp = 0;
+}
+
+void sop_set_workspace(SopContext *ctx, const char *temp_dir, const char *output_dir)
+{
+    SopPaths *p = &(ctx->paths);
+
+    removePrivateTemp(ctx);
+    free(ctx->temp_dir);
+    free(ctx->output_dir);
+    freePaths(p);
+
+    ctx->temp_dir = strdup(temp_dir);
+    ctx->output_dir = strdup(output_dir);
+    ctx->workspace_ready = 0;
+
+    asprintf(&(p->minim), "%s" MINIM_PLA, temp_dir);
+    asprintf(&(p->minimized_out), "%s" MINIMIZED_OUTPUT_PLA, output_dir);
+    asprintf(&(p->espresso_out), "%s" ESPRESSO_OUTPUT_PLA, output_dir);
+    asprintf(&(p->out), "%s" OUTPUT_PLA, output_dir);
+    asprintf(&(p->best), "%s" BEST_OUTPUT_PLA, output_dir);
+    asprintf(&(p->g_file), "%s" G_FILE, temp_dir);
+    asprintf(&(p->f_file), "%s" F_FILE, temp_dir);
+    asprintf(&(p->temp_h), "%s" TEMP_H_DECOMP, temp_dir);
+    asprintf(&(p->g_times_h), "%s" G_TIMES_H_FILE, temp_dir);
+    asprintf(&(p->out_h), "%s" OUT_H_DECOMP, output_dir);
+    asprintf(&(p->temp_h_or), "%s" TEMP_H_OR_DECOMP, temp_dir);
+    asprintf(&(p->out_h_or), "%s" OUT_H_OR_DECOMP, output_dir);
+}
+
+int sop_private_workspace(SopContext *ctx, const char *output_dir)
+{
+    char *temp, *dir, *out = strdup(output_dir);
+
+    if (ensureDir(TEMP_DIR) == -1)
+    {
+        free(out);
+        return -1;
+    }
+
+    asprintf(&temp, "%srun-XXXXXX", TEMP_DIR);
+    if (mkdtemp(temp) == NULL)
+    {
+        fprintf(stderr, "[!!] impossibile creare una cartella temporanea in %s: ", TEMP_DIR);
+        perror("");
+        free(temp);
+        free(out);
+        return -1;
+    }
+
+    asprintf(&dir, "%s/", temp);
+    sop_set_workspace(ctx, dir, out);
+    ctx->private_temp = 1;
+
+    free(temp);
+    free(dir);
+    free(out);
+    return 0;
+}
+
+void sop_copy_options(SopContext *dst, const SopContext *src)
+{
+    dst->threads = src->threads;
+    dst->lazy = src->lazy;
+    dst->bounded = src->bounded;
+    dst->beam_width = src->beam_width;
+    dst->beam_depth = src->beam_depth;
+    dst->frontend = src->frontend;
+    dst->decomp = src->decomp;
+    dst->portfolio = src->portfolio;
+    dst->dd_stats.enabled = src->dd_stats.enabled;
+    sop_set_cache(dst, src->cache_dir);
+}
+
+void sop_set_cache(SopContext *ctx, const char *cache_dir)
+{
+    free(ctx->cache_dir);
+    ctx->cache_dir = (cache_dir != NULL) ? strdup(cache_dir) : NULL;
+    ctx->workspace_ready = 0;
+}
+
+void sop_set_checkpoint(SopContext *ctx, const char *dir, int every)
+{
+    free(ctx->ckpt.dir);
+    ctx->ckpt.dir = (dir != NULL) ? strdup(dir) : NULL;
+    ctx->ckpt.every = every;
+    ctx->ckpt.bdd_saved = 0;
+    ctx->workspace_ready = 0;
+}
+
+void sop_set_incremental(SopContext *ctx, const char *dir)
+{
+    free(ctx->incr.base_dir);
+    ctx->incr.base_dir = (dir != NULL) ? strdup(dir) : NULL;
+}
+
+void sop_set_trace(SopContext *ctx, const char *path)
+{
+    free(ctx->trace.path);
+    ctx->trace.path = (path != NULL) ? strdup(path) : NULL;
+}
+
+void sop_set_progress(SopContext *ctx, const char *path)
+{
+    free(ctx->progress.path);
+    ctx->progress.path = (path != NULL) ? strdup(path) : NULL;
+}
+
+int sop_set_frontend(SopContext *ctx, const char *name)
+{
+    for (int i = 0; i < N_FRONTENDS; i++)
+    {
+        if (strcmp(name, frontend_names[i]) == 0)
+        {
+            ctx->frontend = i;
+            return 0;
+        }
+    }
+
+    fprintf(stderr, "[!!] front-end %s non valido, scegliere tra espresso, isop e isop-expand\n", name);
+    return -1;
+}
+
+int sop_set_decomposition(SopContext *ctx, const char *name)
+{
+    for (int i = 0; i < N_DECOMPOSITIONS; i++)
+    {
+        if (strcmp(name, decomposition_names[i]) == 0)
+        {
+            ctx->decomp = i;
+            return 0;
+        }
+    }
+
+    fprintf(stderr, "[!!] decomposizione %s non valida, scegliere tra and e best\n", name);
+    return -1;
+}
+
+int sop_set_error(SopContext *ctx, SopErrorMode mode, const char *error)
+{
+    char *endptr;
+    long res;
+
+    ctx->error_mode = mode;
+    ctx->ct_percent = (error[strlen(error) - 1] == '%');
+
+    errno = 0;
+    res = strtol(error, &endptr, 10);
+    if (endptr == error)
+    {
+        fprintf(stderr, "[!!] impossibile parsare il valore\n");
+        return -1;
+    }
+    if ((res == LONG_MAX || res == LONG_MIN) && errno == ERANGE)
+    {
+        fprintf(stderr, "[!!] il valore è out of range\n");
+        return -1;
+    }
+    if (res <= 0)
+    {
+        fprintf(stderr, "[!!] L'errore deve essere >= 0\n");
+        return -1;
+    }
+    if ((ctx->ct_percent) && (res > 100))
+    {
+        fprintf(stderr, "[!!] L'errore percentuale non può superare il 100%%\n");
+        return -1;
+    }
+
+    ctx->ct = res;
+    return 0;
+}
+
+/**
+ * @brief Creazione delle directory di lavoro e del manager di un contesto
+ *
+ * @param ctx il contesto
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int prepareContext(SopContext *ctx)
+{
+    if (!ctx->workspace_ready)
+    {
+        if ((ensureDir(ctx->temp_dir) == -1) || (ensureDir(ctx->output_dir) == -1) ||
+            ((ctx->cache_dir != NULL) && (ensureDir(ctx->cache_dir) == -1)) ||
+            ((ctx->ckpt.dir != NULL) && (ensureDir(ctx->ckpt.dir) == -1)))
+            return -1;
+        ctx->workspace_ready = 1;
+    }
+
+    if (ctx->manager == NULL)
+        ctx->manager = Cudd_Init(0, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+    ddstats_attach(ctx);
+
+    return 0;
+}
+
+/**
+ * @brief Prodotti raccolti dalla copertura di un output
+ */
+typedef struct CoverBuffer
+{
+    int *cubes;
+    int len;
+    int size;
+    int num_in;
+} CoverBuffer;
+
+/**
+ * @brief Accodamento di un prodotto della copertura al buffer
+ */
+static void coverToBuffer(const int *cube, void *arg)
+{
+    CoverBuffer *b = arg;
+
+    if (b->len == b->size)
+    {
+        b->size = b->size ? 2 * b->size : 64;
+        b->cubes = safe_realloc(b->cubes, (size_t)b->size * b->num_in * sizeof(int));
+    }
+    memcpy(b->cubes + (size_t)(b->len++) * b->num_in, cube, b->num_in * sizeof(int));
+}
+
+/**
+ * @brief Front-end senza espresso: la copertura di partenza di ogni output è la ISOP
+ *  di [On-set, On-set + DC-set], eventualmente espansa e resa irridondante
+ *
+ * @param ctx il contesto
+ * @param on l'On-set della funzione di ingresso
+ * @return int -1 se una copertura non può essere calcolata, 0 altrimenti
+ */
+static int isopFrontEnd(SopContext *ctx, ParsedPLA *on)
+{
+    DdManager *manager = ctx->manager;
+    ParsedPLA *min = &(ctx->minimized);
+    CoverBuffer b = {NULL, 0, 0, on->num_in};
+    int ret = 0;
+
+    min->num_in = ctx->num_in = on->num_in;
+    min->num_out = ctx->num_out = on->num_out;
+    min->vectorbdd_F = safe_malloc(min->num_out * sizeof(DdNode *));
+    initParsedPLA(min);
+
+    for (int o = 0; o < min->num_out; o++)
+    {
+        DdNode *upper = Cudd_bddOr(manager, on->vectorbdd_F[o], ctx->dcset.vectorbdd_F[o]);
+        Cudd_Ref(upper);
+
+        b.len = 0;
+        if ((ret == 0) && (writeCover(ctx, on->vectorbdd_F[o], upper, coverToBuffer, &b, o) == -1))
+        {
+            /* gli output restanti restano vuoti, la struttura è rilasciata dal chiamante */
+            ret = -1;
+            b.len = 0;
+        }
+        if ((ret == 0) && (ctx->frontend == FRONTEND_ISOP_EXPAND))
+            b.len = cover_reduce(manager, on->vectorbdd_F[o], upper, b.cubes, b.len, b.num_in);
+        Cudd_RecursiveDeref(manager, upper);
+
+        min->vectorbdd_F[o] = Cudd_ReadLogicZero(manager);
+        Cudd_Ref(min->vectorbdd_F[o]);
+        for (int j = 0; j < b.len; j++)
+        {
+            int *cube = b.cubes + (size_t)j * b.num_in;
+            DdNode *prod = construct_product(manager, cube, b.num_in);
+            DdNode *tmp = Cudd_bddOr(manager, min->vectorbdd_F[o], prod);
+            Cudd_Ref(tmp);
+            Cudd_RecursiveDeref(manager, prod);
+            Cudd_RecursiveDeref(manager, min->vectorbdd_F[o]);
+            min->vectorbdd_F[o] = tmp;
+
+            cube_append(min, o, cube);
+        }
+    }
+
+    free(b.cubes);
+    return ret;
+}
+
+int sop_parse(SopContext *ctx, char *inputfile)
+{
+    SopPaths *p = &(ctx->paths);
+
+    /* ogni gruppo di output viene chiuso prima del successivo: niente stato globale */
+    if ((ctx->stream > 0) && ((ctx->error_mode != MULTIPLE_OUTPUT_ERROR) || (ctx->output_mode != TEST_LOG) ||
+                              (ctx->ckpt.dir != NULL) || (ctx->incr.base_dir != NULL) || (ctx->trace.path != NULL)))
+    {
+        fprintf(stderr, "[!!] la modalità streaming richiede -m e -t, senza checkpoint, sintesi incrementale e traccia\n");
+        return -1;
+    }
+
+    /* lo stato della coda limitata non viene salvato */
+    if (ctx->bounded && ((ctx->ckpt.dir != NULL) || (ctx->incr.base_dir != NULL)))
+    {
+        fprintf(stderr, "[!!] la coda limitata (-B) non è compatibile con checkpoint e sintesi incrementale\n");
+        return -1;
+    }
+
+    if ((prepareContext(ctx) == -1) || (progress_open(&(ctx->progress)) == -1))
+        return -1;
+    ddstats_begin(ctx, PHASE_PARSE);
+
+    /* minimizzazione della funzione, se non già presente in cache */
+    char *key = ctx->ckpt.key;
+    char *min_file = p->minim;
+    int cached = 0, espresso = (ctx->frontend == FRONTEND_ESPRESSO);
+
+    /* la chiave identifica la PLA sia nella cache sia nei checkpoint */
+    if (((ctx->cache_dir == NULL) && (ctx->ckpt.dir == NULL)) || (fcache_key(inputfile, key) == -1))
+        key[0] = '\0';
+    else if (espresso && (ctx->cache_dir != NULL))
+        cached = (fcache_lookup(ctx->cache_dir, key, &min_file) == 0);
+
+    if (espresso && !cached)
+    {
+        char *sys_command;
+#ifndef EXACT_MINIMIZATION
+        asprintf(&sys_command, "espresso %s | sed -e '/\\.[p-type]/d' > %s", inputfile, p->minim);
+#endif
+#ifdef EXACT_MINIMIZATION
+        asprintf(&sys_command, "espresso -Dexact %s | sed -e '/\\.[p-type]/d' > %s", inputfile, p->minim);
+#endif
+        system(sys_command);
+        free(sys_command);
+    }
+
+    /* parsing: il DC-set viene letto direttamente dalla PLA di ingresso */
+    int ret = 0, verbose = (ctx->output_mode == VERBOSE_LOG);
+    ParsedPLA input_on = {0};
+    struct test_stats input_stats = {0};
+    if (ctx->stream > 0)
+    {
+        /* solo l'intestazione, ctx->minimized resta senza output fino all'euristica */
+        if (parse_outputs(inputfile, &(ctx->manager), &input_on, NULL, 0, 0, 0) == -1)
+            ret = -1;
+        else
+        {
+            ctx->minimized.num_in = input_on.num_in;
+            ctx->minimized.num_out = input_on.num_out;
+            ctx->stream_input = strdup(inputfile);
+            ctx->stream_min = espresso ? strdup(min_file) : NULL;
+            if (espresso && !cached && (key[0] != '\0') && (ctx->cache_dir != NULL))
+                fcache_store(ctx->cache_dir, key, p->minim);
+        }
+    }
+    /* in modalità verbose le liste di prodotti dell'ingresso servono al riepilogo */
+    else if (parse(inputfile, &(ctx->manager), &input_on, &(ctx->dcset), verbose) == -1)
+        ret = -1;
+    else if (!espresso)
+    {
+        /* copertura calcolata dalle BDD, più rapida di una lettura dalla cache */
+        if (isopFrontEnd(ctx, &input_on) == -1)
+            ret = -1;
+        else
+        {
+            pla_stats(&(ctx->minimized), &(ctx->original_stats));
+            ctx->minimized.in_literals = ctx->original_stats.prod_in;
+        }
+    }
+    else if (parse(min_file, &(ctx->manager), &(ctx->minimized), NULL, 1) == -1)
+        ret = -1;
+    else
+    {
+        /* le righe di espresso possono ripetere un prodotto: i letterali di ingresso sono quelli letti */
+        pla_stats(&(ctx->minimized), &(ctx->original_stats));
+        ctx->original_stats.prod_in = ctx->minimized.in_literals;
+        if (!cached && (key[0] != '\0') && (ctx->cache_dir != NULL))
+            fcache_store(ctx->cache_dir, key, p->minim);
+    }
+
+    /* righe della PLA di ingresso, come lette dal file */
+    if (verbose && (ret == 0) && (input_on.cubes != NULL))
+    {
+        for (int o = 0; o < input_on.num_out; o++)
+        {
+            input_stats.and_lit += input_on.cubes[o].literals;
+            input_stats.or_port += cube_count(&input_on, o);
+        }
+        input_stats.prod_in = input_on.in_literals;
+        input_stats.prod_out = input_stats.or_port;
+    }
+    freeParsedPLA(ctx->manager, &input_on);
+
+    if (cached)
+        free(min_file);
+    if (ret == -1)
+        return -1;
+
+    ctx->num_in = ctx->minimized.num_in;
+    ctx->num_out = ctx->minimized.num_out;
+
+    /* letterali per output della funzione minimizzata, limite della decomposizione per output */
+    if (ctx->stream == 0)
+    {
+        ctx->output_stats = safe_calloc(ctx->num_out, sizeof(struct test_stats));
+        for (int o = 0; o < ctx->num_out; o++)
+        {
+            ctx->output_stats[o].and_lit = ctx->minimized.cubes[o].literals;
+            ctx->output_stats[o].or_port = cube_count(&(ctx->minimized), o);
+        }
+    }
+
+    /* senza espresso, o con la copertura letta dalla cache, il file della funzione
+       minimizzata non è stato scritto e serve solo alla verifica finale */
+    if ((!espresso || cached) && (ctx->output_mode == VERBOSE_LOG) &&
+        (mergeToPLA(ctx, &(ctx->minimized), p->minim) == -1))
+        return -1;
+
+    if ((ctx->ct_percent) && (CHAR_BIT * sizeof(ctx->ct) < ctx->num_in))
+    {
+        fprintf(stderr, "[!!] impossibile utilizzare l'errore percentuale con %d input, "
+                        "specificare il numero di mintermini\n",
+                ctx->num_in);
+        return -1;
+    }
+
+    if (ctx->stream == 0)
+    {
+        ctx->offset = safe_malloc(ctx->num_out * sizeof(DdNode *));
+        for (int i = 0; i < ctx->num_out; i++)
+        {
+            ctx->offset[i] = Cudd_Not(ctx->minimized.vectorbdd_F[i]);
+            Cudd_Ref(ctx->offset[i]);
+        }
+    }
+
+    ddstats_end(ctx, PHASE_PARSE);
+
+    if (ctx->output_mode == VERBOSE_LOG)
+    {
+        printf("NUM IN: %d, NUM OUT: %d\n", ctx->num_in, ctx->num_out);
+        printf("*********************************\nFunzione originale: ");
+        print_verbose_stats(input_stats);
+        if (espresso)
+            printf("Funzione minimizzata: ");
+        else
+            printf("Funzione minimizzata (%s): ", frontend_names[ctx->frontend]);
+        print_verbose_stats(ctx->original_stats);
+    }
+
+    unsigned long long two_pow = (ctx->num_in < 31) ? (1L << ctx->num_in) : powl(2L, ctx->num_in);
+
+    if ((two_pow == 0LL) && (ctx->ct_percent))
+    {
+        fprintf(stderr, "[!!] errore inatteso, chiusura.");
+        return -1;
+    }
+
+    /* la probabilità ct è richiesta in percentuale su 2^NUM_IN */
+    if (ctx->ct_percent)
+    {
+        ctx->r = (double)ctx->ct / 100;
+        ctx->ct = floorl(ctx->r * two_pow);
+    }
+    else
+        ctx->r = (two_pow == 0LL) ? 0.0f : (double)ctx->ct / two_pow;
+
+    return 0;
+}
+
+int sop_resume(SopContext *ctx, const char *dir, char *inputfile)
+{
+    if (ctx->bounded)
+    {
+        fprintf(stderr, "[!!] la coda limitata (-B) non è compatibile con checkpoint e sintesi incrementale\n");
+        return -1;
+    }
+
+    if ((prepareContext(ctx) == -1) || (progress_open(&(ctx->progress)) == -1))
+        return -1;
+    ddstats_begin(ctx, PHASE_PARSE);
+
+    if (ckpt_load(ctx, dir, inputfile) == -1)
+        return -1;
+
+    /* la copertura minimizzata non è nel checkpoint e le liste di prodotti sono già
+       modificate dall'estrazione: per la verifica finale la funzione viene ricostruita
+       dai BDD, salvati prima dell'euristica */
+    if (ctx->output_mode == VERBOSE_LOG)
+    {
+        DdNode **none = safe_malloc(ctx->num_out * sizeof(DdNode *));
+        for (int o = 0; o < ctx->num_out; o++)
+            none[o] = Cudd_ReadLogicZero(ctx->manager);
+
+        int ret = mergeBDDtoFile(ctx, ctx->paths.minim, ctx->minimized.vectorbdd_F, none);
+        free(none);
+        if (ret == -1)
+            return -1;
+    }
+
+    /* i BDD sono già presenti se si continua a salvare nella stessa directory */
+    if (ctx->ckpt.dir == NULL)
+        sop_set_checkpoint(ctx, dir, ctx->ckpt.every);
+    ctx->ckpt.bdd_saved = (strcmp(ctx->ckpt.dir, dir) == 0);
+    ddstats_end(ctx, PHASE_PARSE);
+
+    if (ctx->output_mode == VERBOSE_LOG)
+    {
+        printf("NUM IN: %d, NUM OUT: %d\n", ctx->num_in, ctx->num_out);
+        printf("Ripresa dal checkpoint in %s: %d prodotti già aggiunti, %d candidati in coda\n", dir,
+               ctx->ckpt.resumed->added_product, ctx->ckpt.resumed->queue->len);
+        printf("*********************************\nFunzione minimizzata: ");
+        print_verbose_stats(ctx->original_stats);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Somma delle statistiche di un gruppo di output
+ */
+static void addStats(struct test_stats *total, struct test_stats *s)
+{
+    total->prod_in += s->prod_in;
+    total->prod_out += s->prod_out;
+    total->and_lit += s->and_lit;
+    total->or_port += s->or_port;
+}
+
+/**
+ * @brief Euristica in modalità streaming: gli output vengono letti, approssimati,
+ *  ripuliti dalle ridondanze e scritti a gruppi di ctx->stream, rilasciando le BDD
+ *  del gruppo prima di passare al successivo. Le righe non vengono unite tra gruppi
+ *  diversi e i letterali di ingresso (prod_in) sono sommati per gruppo
+ *
+ * @param ctx il contesto
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int streamHeuristic(SopContext *ctx)
+{
+    DdManager *manager;
+    int num_in = ctx->num_in, num_out = ctx->num_out;
+    int ret = 0;
+    PlaWriter w;
+
+    memset(&(ctx->original_stats), 0, sizeof(struct test_stats));
+    memset(&(ctx->heuristic_stats), 0, sizeof(struct test_stats));
+    ctx->cpu_time = 0;
+    if (pla_writer_open(&w, ctx->paths.minimized_out, num_in, num_out) == -1)
+        return -1;
+
+    char *outs = safe_malloc(num_out);
+    progress_outputs(&(ctx->progress), num_out);
+    for (int first = 0; (first < num_out) && (ret == 0); first += ctx->stream)
+    {
+        int n = min(ctx->stream, num_out - first);
+        ParsedPLA on = {0};
+        struct test_stats s;
+        double group_time;
+
+        if ((parse_outputs(ctx->stream_input, &(ctx->manager), &on, &(ctx->dcset), 0, first, n) == -1) ||
+            ((ctx->stream_min != NULL) &&
+             (parse_outputs(ctx->stream_min, &(ctx->manager), &(ctx->minimized), NULL, 1, first, n) == -1)))
+        {
+            fprintf(stderr, "[!!] impossibile leggere gli output %d-%d\n", first, first + n - 1);
+            ret = -1;
+        }
+        manager = ctx->manager;
+        if ((ret == 0) && (ctx->stream_min == NULL) && (isopFrontEnd(ctx, &on) == -1))
+            ret = -1;
+        freeParsedPLA(manager, &on);
+        if (ret == -1)
+        {
+            freeParsedPLA(manager, &(ctx->minimized));
+            freeParsedPLA(manager, &(ctx->dcset));
+            break;
+        }
+
+        pla_stats(&(ctx->minimized), &s);
+        addStats(&(ctx->original_stats), &s);
+
+        ctx->num_out = n;
+        ctx->offset = safe_malloc(n * sizeof(DdNode *));
+        for (int o = 0; o < n; o++)
+        {
+            ctx->offset[o] = Cudd_Not(ctx->minimized.vectorbdd_F[o]);
+            Cudd_Ref(ctx->offset[o]);
+        }
+
+        ctx->progress.first_output = first;
+        if (heuristic(ctx, &(ctx->minimized), ctx->offset, &(ctx->dcset), &s, &group_time) == -1)
+            ret = -1;
+        else
+        {
+            ctx->cpu_time += group_time;
+            addStats(&(ctx->heuristic_stats), &s);
+
+            /* righe del gruppo, con gli output degli altri gruppi a 0 */
+            PlaRows rows;
+            pla_rows_init(&rows, num_in, n);
+            for (int o = 0; o < n; o++)
+                for (int j = 0; j < ctx->minimized.cubes[o].len; j++)
+                    if (cube_alive(&(ctx->minimized), o, j))
+                        pla_rows_get(&rows, cube_at(&(ctx->minimized), o, j), 0)[o] = '1';
+
+            memset(outs, '0', num_out);
+            for (int i = 0; i < rows.len; i++)
+            {
+                memcpy(outs + first, rows.outs + (size_t)i * n, n);
+                pla_writer_row(&w, rows.cube[i], outs);
+            }
+            pla_rows_free(&rows);
+        }
+
+        /* rilascio del gruppo: offset, funzione minimizzata e DC-set */
+        for (int o = 0; o < n; o++)
+            Cudd_RecursiveDeref(manager, ctx->offset[o]);
+        free(ctx->offset);
+        ctx->offset = NULL;
+        freeParsedPLA(manager, &(ctx->minimized));
+        freeParsedPLA(manager, &(ctx->dcset));
+        ctx->num_out = num_out;
+
+        Cudd_ReduceHeap(manager, CUDD_REORDER_SIFT, 0);
+    }
+
+    if ((pla_writer_close(&w) == -1) && (ret == 0))
+    {
+        fprintf(stderr, "[!!] impossibile scrivere %s\n", ctx->paths.minimized_out);
+        ret = -1;
+    }
+    free(outs);
+
+    return ret;
+}
+
+/**
+ * @brief Copia di un file PLA
+ *
+ * @param src il file sorgente
+ * @param dest il file di destinazione, "-" per lo stdout
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int copyPLA(const char *src, const char *dest)
+{
+    FILE *in = fopen(src, "r");
+    FILE *out = (strcmp(dest, "-") == 0) ? stdout : fopen(dest, "w");
+    char buf[BUFSIZ];
+    size_t n;
+    int ret = 0;
+
+    if ((in == NULL) || (out == NULL))
+        ret = -1;
+    else
+        while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+            if (fwrite(buf, 1, n, out) != n)
+            {
+                ret = -1;
+                break;
+            }
+
+    if (in != NULL)
+        fclose(in);
+    if ((out != NULL) && (out != stdout) && (fclose(out) != 0))
+        ret = -1;
+    else if (out == stdout)
+        fflush(stdout);
+
+    if (ret == -1)
+        fprintf(stderr, "[!!] impossibile scrivere %s\n", dest);
+    return ret;
+}
+
+int sop_heuristic(SopContext *ctx)
+{
+    SopPaths *p = &(ctx->paths);
+    char *sys_command;
+
+    if (ctx->stream > 0)
+    {
+        if (streamHeuristic(ctx) == -1)
+            return -1;
+    }
+    else if ((heuristic(ctx, &(ctx->minimized), ctx->offset, &(ctx->dcset), &(ctx->heuristic_stats),
+                        &(ctx->cpu_time)) == -1) ||
+             (mergeToPLA(ctx, &(ctx->minimized), p->minimized_out) == -1))
+        return -1;
+
+    progress_phase(&(ctx->progress), "espresso");
+    if (ctx->portfolio > 0)
+    {
+        ctx->portfolio_winner = portfolio_run(ctx, p->minimized_out, p->espresso_out, &(ctx->espresso_stats));
+
+        /* nessuna strategia terminata entro la scadenza: resta la PLA euristica */
+        if (ctx->portfolio_winner == NULL)
+        {
+            asprintf(&sys_command, "cp %s %s", p->minimized_out, p->espresso_out);
+            system(sys_command);
+            free(sys_command);
+            ctx->espresso_stats = ctx->heuristic_stats;
+        }
+        if (ctx->output_mode == VERBOSE_LOG)
+            printf("*********************************\nPortfolio: %s\n",
+                   (ctx->portfolio_winner != NULL) ? ctx->portfolio_winner : "nessuna strategia entro la scadenza");
+    }
+    else
+    {
+        asprintf(&sys_command, "espresso %s > %s", p->minimized_out, p->espresso_out);
+        system(sys_command);
+        free(sys_command);
+        if (getPLAFileData(p->espresso_out, ctx->num_out, &(ctx->espresso_stats)) == -1)
+            return -1;
+    }
+
+    /**
+     * @brief scegliamo tra la PLA dopo euristica e la PLA dopo euristica + espresso
+     *        quale delle due fornisce la riduzione maggiore di letterali e la scegliamo per il
+     *        confronto con la PLA originale minimizzata.
+     * NOTA: la precedenza viene data alla PLA col
+     *          1. minor numero di porte OR
+     *          2. minor numero di letterali AND
+     *          3. PLA euristica + espresso
+     */
+    int is_espresso_best;
+
+    if (ctx->heuristic_stats.or_port == ctx->espresso_stats.or_port)
+        is_espresso_best = (ctx->espresso_stats.and_lit <= ctx->heuristic_stats.and_lit);
+    else
+        is_espresso_best = (ctx->espresso_stats.or_port < ctx->heuristic_stats.or_port);
+
+    if (is_espresso_best)
+    {
+        ctx->chosen = &(ctx->espresso_stats);
+        asprintf(&sys_command, "cp %s %s", p->espresso_out, p->best);
+    }
+    else
+    {
+        ctx->chosen = &(ctx->heuristic_stats);
+        asprintf(&sys_command, "cp %s %s", p->minimized_out, p->best);
+    }
+    system(sys_command);
+    free(sys_command);
+
+    if (ctx->output_mode == VERBOSE_LOG)
+    {
+        printf("*********************************\nConfronto con PLA Espresso:\n");
+        fflush(stdout);
+        asprintf(&sys_command, "espresso -Dverify %s %s", p->minimized_out, p->minim);
+        system(sys_command);
+        free(sys_command);
+        printf("\n*********************************\nConfronto con PLA euristica con ridondanze:\n");
+        fflush(stdout);
+        asprintf(&sys_command, "espresso -Dverify %s %s", p->minimized_out, p->out);
+        system(sys_command);
+        free(sys_command);
+        printf("\n*********************************\nEsecuzione di Espresso sulla PLA euristica senza ridondanze:\n");
+        print_verbose_stats(ctx->espresso_stats);
+    }
+
+    return 0;
+}
+
+int sop_write_pla(SopContext *ctx, const char *filename)
+{
+    /* in streaming le liste di prodotti sono già state rilasciate */
+    if (ctx->stream > 0)
+        return copyPLA(ctx->paths.minimized_out, filename);
+    return mergeToPLA(ctx, &(ctx->minimized), filename);
+}
+
+int sop_decomposition(SopContext *ctx, char *inputfile)
+{
+    ddstats_begin(ctx, PHASE_DECOMPOSITION);
+    if (ctx->decomp == DECOMP_BEST)
+    {
+        /* i contatori sono calcolati per output dalla decomposizione */
+        if (bestDecomposition(ctx, &(ctx->dcset), ctx->paths.minimized_out, inputfile) == -1)
+            return -1;
+        ddstats_end(ctx, PHASE_DECOMPOSITION);
+        return 0;
+    }
+
+    if (andDecomposition(ctx, &(ctx->dcset), ctx->paths.minimized_out, inputfile) == -1)
+        return -1;
+    ddstats_end(ctx, PHASE_DECOMPOSITION);
+
+    ctx->decomp_stats.and_lit = ctx->chosen->and_lit + ctx->h_stats.and_lit;
+    ctx->decomp_stats.or_port = ctx->chosen->or_port + ctx->h_stats.or_port;
+
+    return 0;
+}
+
+void sop_stats(SopContext *ctx, SopGain *g)
+{
+    struct test_stats *orig = &(ctx->original_stats);
+
+    g->or_diff = orig->or_port - ctx->chosen->or_port;
+    g->or_perc = (orig->or_port > 0) ? ((double)g->or_diff / orig->or_port) * 100 : 0;
+    g->and_diff = orig->and_lit - ctx->chosen->and_lit;
+    g->and_perc = ((double)g->and_diff / orig->and_lit) * 100;
+
+    g->tot_perc = ((double)g->or_diff + g->and_diff) / (orig->or_port + orig->and_lit) * 100;
+}
+
+void sop_print_csv(SopContext *ctx, const char *inputfile, FILE *f)
+{
+    char *pla_name = strdup(inputfile);
+    char *name = basename(pla_name);
+    int len = strlen(name);
+    double cpu_time = (ctx->cpu_time == 0.00f) ? 0.01f : ctx->cpu_time;
+
+    if ((len > 4) && (strcmp(name + len - 4, ".pla") == 0))
+        name[len - 4] = '\0';
+
+    fprintf(f, "%s (%d/%d); %lli; %g; %d; %d; %d; %d; %.2f; %s",
+            name, ctx->num_in, ctx->num_out, ctx->ct, (ctx->r * (double)100),
+            ctx->original_stats.and_lit, ctx->original_stats.or_port,
+            ctx->chosen->and_lit, ctx->chosen->or_port,
+            cpu_time, frontend_names[ctx->frontend]);
+    ddstats_print_csv(ctx, f);
+    fprintf(f, "\n");
+
+    free(pla_name);
+}
+
+void sop_reset(SopContext *ctx)
+{
+    progress_close(&(ctx->progress));
+    if (ctx->manager != NULL)
+        cleanRoutine(ctx);
+
+    ctx->num_in = ctx->num_out = 0;
+    ctx->r = 0;
+    ctx->cpu_time = 0;
+    ctx->chosen = NULL;
+    ctx->portfolio_winner = NULL;
+    ctx->ckpt.bdd_saved = 0;
+    memset(&(ctx->original_stats), 0, sizeof(struct test_stats));
+    memset(&(ctx->heuristic_stats), 0, sizeof(struct test_stats));
+    memset(&(ctx->espresso_stats), 0, sizeof(struct test_stats));
+    memset(&(ctx->h_stats), 0, sizeof(struct test_stats));
+    memset(&(ctx->decomp_stats), 0, sizeof(struct test_stats));
+    memset(ctx->dd_stats.sampled, 0, sizeof(ctx->dd_stats.sampled));
+}
+
+void sop_free(SopContext *ctx)
+{
+    progress_close(&(ctx->progress));
+    if (ctx->manager != NULL)
+    {
+        cleanRoutine(ctx);
+        Cudd_Quit(ctx->manager);
+        ctx->manager = NULL;
+    }
+
+    removePrivateTemp(ctx);
+    freePaths(&(ctx->paths));
+    free(ctx->temp_dir);
+    free(ctx->output_dir);
+    free(ctx->cache_dir);
+    free(ctx->ckpt.dir);
+    free(ctx->incr.base_dir);
+    free(ctx->trace.path);
+    free(ctx->progress.path);
+}
@@ -0,0 +1,353 @@
+/**
+ * @file libsop.h
+ * @author Marco Costa
+ * @brief Interfaccia del motore di sintesi approssimata. Tutto lo stato di una
+ *  sintesi è contenuto in un SopContext, più contesti possono coesistere nello
+ *  stesso processo (uno per thread). Gli errori sono segnalati su stderr e
+ *  restituiti al chiamante, solo l'esaurimento della memoria termina il processo
+ * @date 2019-11-21
+ */
+
+#ifndef _LIBSOP_H
+#define _LIBSOP_H
+
+#include <stdio.h>
+#include <cudd.h>
+
+#include "libpla.h"
+#include "ddstats.h"
+#include "checkpoint.h"
+#include "trace.h"
+#include "progress.h"
+
+/**
+ * @brief definisce il tipo di errore ammesso
+ */
+typedef enum
+{
+    GLOBAL_OUTPUT_ERROR,
+    MULTIPLE_OUTPUT_ERROR
+} SopErrorMode;
+
+/**
+ * @brief definisce il minimizzatore che produce la copertura di partenza
+ */
+typedef enum
+{
+    FRONTEND_ESPRESSO,    /**< espresso (-Dexact con EXACT_MINIMIZATION) */
+    FRONTEND_ISOP,        /**< ISOP su [On-set, On-set + DC-set] */
+    FRONTEND_ISOP_EXPAND, /**< ISOP seguita da una passata di espansione e irridondanza */
+    N_FRONTENDS
+} SopFrontEnd;
+
+/**
+ * @brief definisce la decomposizione della funzione originale
+ */
+typedef enum
+{
+    DECOMP_AND,  /**< f = g * h con g la PLA euristica */
+    DECOMP_BEST, /**< per ogni output la migliore tra f = g * h, f = g_u + h e la funzione minimizzata */
+    N_DECOMPOSITIONS
+} SopDecomposition;
+
+/**
+ * @brief definisce il tipo di output prodotto dal motore
+ */
+typedef enum
+{
+    VERBOSE_LOG,
+    TEST_LOG,
+    DECOMPOSITION_LOG
+} SopOutputMode;
+
+/**
+ * @brief Percorsi completi dei file intermedi e di output di un contesto
+ */
+typedef struct SopPaths
+{
+    char *minim;         /**< funzione minimizzata da espresso */
+    char *minimized_out; /**< PLA euristica senza ridondanze */
+    char *espresso_out;  /**< PLA euristica + espresso */
+    char *out;           /**< PLA euristica con ridondanze */
+    char *best;          /**< migliore tra euristica ed euristica + espresso */
+    char *g_file;        /**< decomposizione: On-set di g */
+    char *f_file;        /**< decomposizione: On-set di f */
+    char *temp_h;        /**< decomposizione: funzione h da minimizzare */
+    char *g_times_h;     /**< decomposizione: g * h per la verifica */
+    char *out_h;         /**< decomposizione: funzione h minimizzata */
+    char *temp_h_or;     /**< decomposizione OR: funzione h da minimizzare */
+    char *out_h_or;      /**< decomposizione OR: funzione h minimizzata */
+} SopPaths;
+
+/**
+ * @brief Contesto di una singola sintesi
+ */
+typedef struct SopContext
+{
+    DdManager *manager;        /**< CUDD manager */
+    int num_in;                /**< numero di ingressi */
+    int num_out;               /**< numero di uscite */
+    SopErrorMode error_mode;   /**< tipo di errore ammesso */
+    SopOutputMode output_mode; /**< tipo di output */
+    unsigned long long ct;     /**< complementable terms */
+    double r;                  /**< errore in rapporto a 2^num_in */
+    int ct_percent;            /**< se ct è espresso in percentuale */
+    int threads;               /**< thread per la valutazione dei candidati di un output */
+    int lazy;                  /**< ricalcolo lazy (CELF) delle priorità all'estrazione */
+    int bounded;               /**< coda limitata ai migliori candidati di ogni output */
+    int beam_width;            /**< espansioni conservate per livello nella ricerca beam, 0 se disattivata */
+    int beam_depth;            /**< letterali rimossi al più nella ricerca beam */
+    SopFrontEnd frontend;      /**< minimizzatore della funzione di ingresso */
+    SopDecomposition decomp;   /**< decomposizione della funzione originale */
+    double portfolio;          /**< scadenza del portfolio di post-minimizzazioni [s], 0 se disattivato */
+    int stream;                /**< output per gruppo nella modalità streaming, 0 se disattivata */
+
+    char *temp_dir;      /**< directory dei file temporanei */
+    char *output_dir;    /**< directory dei file di output */
+    SopPaths paths;      /**< percorsi dei file */
+    char *cache_dir;     /**< directory della cache di espresso, NULL se disattivata */
+    int workspace_ready; /**< se le directory sono già state create */
+    int private_temp;    /**< se temp_dir è stata creata da sop_private_workspace */
+    char *stream_input;  /**< modalità streaming: la PLA di ingresso */
+    char *stream_min;    /**< modalità streaming: la copertura di espresso, NULL con il front-end ISOP */
+
+    ParsedPLA minimized; /**< funzione minimizzata con le liste di prodotti */
+    ParsedPLA dcset;     /**< DC-set della funzione */
+    DdNode **offset;     /**< Off-set della funzione minimizzata */
+    Arena candidates;    /**< prodotti espansi dell'euristica, rilasciati tutti insieme */
+
+    struct test_stats original_stats;  /**< funzione minimizzata */
+    struct test_stats *output_stats;   /**< funzione minimizzata per output, NULL in modalità streaming */
+    struct test_stats heuristic_stats; /**< euristica senza ridondanze */
+    struct test_stats espresso_stats;  /**< euristica + espresso */
+    struct test_stats h_stats;         /**< funzione h della decomposizione */
+    struct test_stats decomp_stats;    /**< g * h */
+    struct test_stats *chosen;         /**< la PLA scelta tra euristica ed euristica + espresso */
+    double cpu_time;                   /**< tempo di calcolo dell'euristica */
+    const char *portfolio_winner;      /**< strategia vincente del portfolio, NULL se nessuna */
+
+    SopDdStats dd_stats;  /**< contatori del manager per fase */
+    SopCheckpoint ckpt;   /**< checkpoint dell'euristica */
+    SopIncremental incr;  /**< sintesi incrementale */
+    SopTrace trace;       /**< traccia binaria dell'estrazione */
+    SopProgress progress; /**< file di avanzamento */
+} SopContext;
+
+/**
+ * @brief Guadagno della PLA scelta rispetto alla PLA originale minimizzata
+ */
+typedef struct SopGain
+{
+    int or_diff;
+    int and_diff;
+    double or_perc;
+    double and_perc;
+    double tot_perc;
+} SopGain;
+
+/**
+ * @brief Inizializzazione di un contesto con i valori di default
+ *
+ * @param ctx il contesto
+ */
+void sop_init(SopContext *ctx);
+
+/**
+ * @brief Imposta le directory di lavoro del contesto
+ *
+ * @param ctx il contesto
+ * @param temp_dir directory dei file temporanei (terminata da '/')
+ * @param output_dir directory dei file di output (terminata da '/')
+ */
+void sop_set_workspace(SopContext *ctx, const char *temp_dir, const char *output_dir);
+
+/**
+ * @brief Imposta una directory dei file temporanei riservata al contesto, creata
+ *  con mkdtemp in TEMP_DIR: più processi possono lavorare in parallelo senza
+ *  sovrascrivere i file intermedi. La directory viene rimossa con il suo contenuto
+ *  da sop_free o da una nuova sop_set_workspace
+ *
+ * @param ctx il contesto
+ * @param output_dir directory dei file di output (terminata da '/')
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int sop_private_workspace(SopContext *ctx, const char *output_dir);
+
+/**
+ * @brief Copia delle opzioni del motore (thread, estrazione, coda, ricerca beam,
+ *  front-end, decomposizione, portfolio, contatori CUDD e cache) da un contesto
+ *  modello, per esempio nei worker della modalità server. Errore, workspace e file
+ *  della singola sintesi (checkpoint, traccia, avanzamento) non vengono copiati
+ *
+ * @param dst il contesto da configurare
+ * @param src il contesto modello
+ */
+void sop_copy_options(SopContext *dst, const SopContext *src);
+
+/**
+ * @brief Imposta la directory della cache dei risultati di espresso
+ *
+ * @param ctx il contesto
+ * @param cache_dir la directory (terminata da '/'), NULL per disattivare la cache
+ */
+void sop_set_cache(SopContext *ctx, const char *cache_dir);
+
+/**
+ * @brief Attiva i checkpoint dell'euristica: dopo la generazione dei candidati e,
+ *  se every > 0, ogni every prodotti accettati
+ *
+ * @param ctx il contesto
+ * @param dir la directory dei checkpoint (terminata da '/'), NULL per disattivarli
+ * @param every la frequenza in prodotti accettati
+ */
+void sop_set_checkpoint(SopContext *ctx, const char *dir, int every);
+
+/**
+ * @brief Attiva la sintesi incrementale: gli output con prodotti, DC-set ed errore
+ *  ammesso invariati rispetto alla base salvata in dir non vengono ricalcolati.
+ *  Il front-end viene comunque eseguito sull'intera PLA; con GLOBAL_OUTPUT_ERROR
+ *  si evita solo la generazione dei candidati e l'estrazione è completa.
+ *  La base della sintesi corrente viene salvata nella directory dei checkpoint
+ *
+ * @param ctx il contesto
+ * @param dir la directory della base (terminata da '/'), NULL per disattivarla
+ */
+void sop_set_incremental(SopContext *ctx, const char *dir);
+
+/**
+ * @brief Attiva la traccia binaria delle decisioni dell'estrazione greedy,
+ *  decodificabile con tracedump
+ *
+ * @param ctx il contesto
+ * @param path il file della traccia, NULL per disattivarla
+ */
+void sop_set_trace(SopContext *ctx, const char *path);
+
+/**
+ * @brief Attiva il file di avanzamento, riscritto ogni PROGRESS_PERIOD_MS da
+ *  sop_parse (o sop_resume) fino a sop_reset o sop_free
+ *
+ * @param ctx il contesto
+ * @param path il file, NULL per disattivarlo
+ */
+void sop_set_progress(SopContext *ctx, const char *path);
+
+/**
+ * @brief Imposta il minimizzatore della funzione di ingresso
+ *
+ * @param ctx il contesto
+ * @param name "espresso", "isop" o "isop-expand"
+ * @return int -1 se il nome non è valido, 0 altrimenti
+ */
+int sop_set_frontend(SopContext *ctx, const char *name);
+
+/**
+ * @brief Imposta la decomposizione della funzione originale
+ *
+ * @param ctx il contesto
+ * @param name "and" o "best"
+ * @return int -1 se il nome non è valido, 0 altrimenti
+ */
+int sop_set_decomposition(SopContext *ctx, const char *name);
+
+/**
+ * @brief Imposta il tipo e il valore dell'errore ammesso
+ *
+ * @param ctx il contesto
+ * @param mode il tipo di errore
+ * @param error il valore, in mintermini o in percentuale se termina con '%'
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int sop_set_error(SopContext *ctx, SopErrorMode mode, const char *error);
+
+/**
+ * @brief Parsing e minimizzazione della funzione con il front-end scelto. Se la
+ *  cache è attiva espresso viene eseguito solo alla prima esecuzione su una stessa PLA.
+ *  In modalità streaming viene letta solo l'intestazione, gli output sono letti a
+ *  gruppi da sop_heuristic
+ *
+ * @param ctx il contesto
+ * @param inputfile il file PLA
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int sop_parse(SopContext *ctx, char *inputfile);
+
+/**
+ * @brief Alternativa a sop_parse: ripristino della funzione e dello stato
+ *  dell'euristica da un checkpoint, senza espresso né generazione dei candidati.
+ *  L'errore ammesso è quello salvato nel checkpoint
+ *
+ * @param ctx il contesto
+ * @param dir la directory del checkpoint (terminata da '/')
+ * @param inputfile la PLA da cui è stato generato il checkpoint
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int sop_resume(SopContext *ctx, const char *dir, char *inputfile);
+
+/**
+ * @brief Euristica di sintesi approssimata, seguita da espresso (o dal portfolio di
+ *  post-minimizzazioni se ctx->portfolio > 0) e dalla scelta della PLA migliore
+ *
+ * @param ctx il contesto
+ * @return int -1 in caso di errore, 0 altrimenti; il tempo di calcolo
+ *  dell'euristica è in ctx->cpu_time
+ */
+int sop_heuristic(SopContext *ctx);
+
+/**
+ * @brief Scrittura della PLA euristica senza ridondanze direttamente dalle liste
+ *  di prodotti, dopo sop_heuristic. In modalità streaming viene copiata la PLA
+ *  scritta a gruppi dall'euristica
+ *
+ * @param ctx il contesto
+ * @param filename il file, "-" per lo stdout
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int sop_write_pla(SopContext *ctx, const char *filename);
+
+/**
+ * @brief Decomposizione della funzione originale a partire dalla PLA euristica: AND,
+ *  o la migliore tra AND e OR per ogni output con DECOMP_BEST
+ *
+ * @param ctx il contesto
+ * @param inputfile il file PLA originale
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int sop_decomposition(SopContext *ctx, char *inputfile);
+
+/**
+ * @brief Calcolo del guadagno rispetto alla PLA originale
+ *
+ * @param ctx il contesto
+ * @param g il guadagno
+ */
+void sop_stats(SopContext *ctx, SopGain *g);
+
+/**
+ * @brief Stampa del risultato in formato CSV
+ *
+ * FORMATTAZIONE: nome_file (in/out); ct; r; orig_and; orig_or; new_and; new_or; CPU_time[s]; front-end
+ *  seguita dai contatori per fase se il campionamento è attivo
+ *
+ * @param ctx il contesto
+ * @param inputfile il file PLA originale
+ * @param f il file di output
+ */
+void sop_print_csv(SopContext *ctx, const char *inputfile, FILE *f);
+
+/**
+ * @brief Rilascio delle risorse della sintesi corrente mantenendo il CUDD manager,
+ *  che può essere riutilizzato per una nuova sintesi
+ *
+ * @param ctx il contesto
+ */
+void sop_reset(SopContext *ctx);
+
+/**
+ * @brief Rilascio di tutte le risorse del contesto, incluso il CUDD manager
+ *
+ * @param ctx il contesto
+ */
+void sop_free(SopContext *ctx);
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ * @file portfolio.c
+ * @author Marco Costa
+ * @brief Implementazione del portfolio di post-minimizzazioni
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "portfolio.h"
+#include "libsop.h"
+
+/* intervallo di controllo dei processi in corso */
+#define PORTFOLIO_POLL_NS 10000000L
+
+/**
+ * @brief Configurazione di espresso
+ */
+typedef struct Strategy
+{
+    const char *name;
+    const char *option; /**< opzione di espresso, NULL per nessuna */
+} Strategy;
+
+static const Strategy strategies[] = {{"plain", NULL}, {"strong", "-estrong"}, {"exact", "-Dexact"}};
+
+/* la copertura esatta ha il minimo numero di prodotti, non di porte OR o letterali AND:
+   ogni strategia può vincere e viene interrotta solo alla scadenza */
+#define N_STRATEGIES (int)(sizeof(strategies) / sizeof(Strategy))
+
+/**
+ * @brief Avvio di espresso con l'output rediretto su file
+ *
+ * @return pid_t il pid del processo, -1 in caso di errore
+ */
+static pid_t launch(const Strategy *st, const char *pla, const char *file)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+
+    int fd = open(file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if ((fd == -1) || (dup2(fd, STDOUT_FILENO) == -1))
+        _exit(EXIT_FAILURE);
+    close(fd);
+
+    if (st->option != NULL)
+        execlp("espresso", "espresso", st->option, pla, (char *)NULL);
+    else
+        execlp("espresso", "espresso", pla, (char *)NULL);
+    _exit(127);
+}
+
+/**
+ * @brief Terminazione di un processo del portfolio
+ */
+static void cancel(pid_t *pid)
+{
+    kill(*pid, SIGKILL);
+    waitpid(*pid, NULL, 0);
+    *pid = 0;
+}
+
+/**
+ * @brief Secondi trascorsi da start
+ */
+static double elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+const char *portfolio_run(struct SopContext *ctx, const char *pla, const char *out, struct test_stats *s)
+{
+    pid_t pid[N_STRATEGIES];
+    char *file[N_STRATEGIES];
+    int running = 0, best = -1;
+    struct timespec start, pause = {0, PORTFOLIO_POLL_NS};
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < N_STRATEGIES; i++)
+    {
+        asprintf(&(file[i]), "%sportfolio-%s.pla", ctx->temp_dir, strategies[i].name);
+        pid[i] = launch(&(strategies[i]), pla, file[i]);
+        if (pid[i] == -1)
+        {
+            perror("[!!] impossibile avviare espresso");
+            pid[i] = 0;
+        }
+        else
+            running++;
+    }
+
+    while (running > 0)
+    {
+        for (int i = 0; i < N_STRATEGIES; i++)
+        {
+            int status;
+
+            if ((pid[i] == 0) || (waitpid(pid[i], &status, WNOHANG) != pid[i]))
+                continue;
+            pid[i] = 0;
+            running--;
+            if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+                continue;
+
+            struct test_stats st;
+            if (getPLAFileData(file[i], ctx->num_out, &st) == -1)
+                continue;
+            if ((best == -1) || (st.or_port < s->or_port) || ((st.or_port == s->or_port) && (st.and_lit < s->and_lit)))
+            {
+                best = i;
+                *s = st;
+            }
+        }
+
+        if (running == 0)
+            break;
+        if (elapsed(&start) < ctx->portfolio)
+            nanosleep(&pause, NULL);
+        else
+        {
+            for (int i = 0; i < N_STRATEGIES; i++)
+                if (pid[i] != 0)
+                    cancel(&(pid[i]));
+            running = 0;
+        }
+    }
+
+    if ((best != -1) && (rename(file[best], out) == -1))
+    {
+        perror("[!!] impossibile salvare il risultato del portfolio");
+        best = -1;
+    }
+    for (int i = 0; i < N_STRATEGIES; i++)
+    {
+        if (i != best)
+            unlink(file[i]);
+        free(file[i]);
+    }
+
+    return (best == -1) ? NULL : strategies[best].name;
+}
@@ -0,0 +1,31 @@
+#ifndef _PORTFOLIO_H
+#define _PORTFOLIO_H
+
+/**
+ * @file portfolio.h
+ * @author Marco Costa
+ * @brief Portfolio di post-minimizzazioni della PLA euristica: più configurazioni
+ *  di espresso eseguite in parallelo entro una scadenza comune, delle quali si
+ *  tiene la copertura migliore
+ */
+
+#include "libpla.h"
+
+struct SopContext;
+
+/**
+ * @brief Esecuzione del portfolio su pla entro ctx->portfolio secondi. Vince la
+ *  copertura con meno porte OR e, a parità, meno letterali AND; a parità completa
+ *  la prima terminata. Non esiste un limite inferiore al risultato di una strategia
+ *  in corso, quindi nessuna viene terminata prima della scadenza: il portfolio dura
+ *  fino alla scadenza o fino al termine dell'ultima strategia
+ *
+ * @param ctx il contesto
+ * @param pla la PLA euristica senza ridondanze
+ * @param out il file in cui scrivere la copertura vincente
+ * @param s le statistiche della copertura vincente
+ * @return const char* il nome della strategia vincente, NULL se nessuna è terminata
+ */
+const char *portfolio_run(struct SopContext *ctx, const char *pla, const char *out, struct test_stats *s);
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file progress.c
+ * @author Marco Costa
+ * @brief Implementazione del file di avanzamento di una sintesi
+ */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "progress.h"
+#include "utils.h"
+
+/**
+ * @brief Istante corrente in secondi
+ */
+static double now(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Scrittura dello stato su un file temporaneo rinominato su path, così chi
+ *  legge trova sempre un file completo
+ *
+ * @param p i contatori
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int writeProgress(SopProgress *p)
+{
+    char *tmp;
+    int ret = 0;
+
+    asprintf(&tmp, "%s.tmp", p->path);
+    FILE *f = fopen(tmp, "w");
+    if (f == NULL)
+    {
+        free(tmp);
+        return -1;
+    }
+
+    fprintf(f, "pid %d\n", (int)getpid());
+    fprintf(f, "phase %s\n", __atomic_load_n(&(p->phase), __ATOMIC_RELAXED));
+    fprintf(f, "elapsed %.3f\n", now(CLOCK_MONOTONIC) - p->start);
+    fprintf(f, "updated %ld\n", (long)time(NULL));
+    fprintf(f, "cubes %lld %lld\n", (long long)__atomic_load_n(&(p->cubes_done), __ATOMIC_RELAXED),
+            (long long)__atomic_load_n(&(p->cubes_total), __ATOMIC_RELAXED));
+    fprintf(f, "candidates %lld\n", (long long)__atomic_load_n(&(p->generated), __ATOMIC_RELAXED));
+    fprintf(f, "queue %lld\n", (long long)__atomic_load_n(&(p->queue_len), __ATOMIC_RELAXED));
+    fprintf(f, "accepted %lld\n", (long long)__atomic_load_n(&(p->accepted), __ATOMIC_RELAXED));
+    fprintf(f, "error %lld\n", (long long)__atomic_load_n(&(p->total_error), __ATOMIC_RELAXED));
+    fprintf(f, "errors");
+    for (int o = 0; o < p->n_errors; o++)
+        fprintf(f, " %lld", (long long)__atomic_load_n(&(p->errors[o]), __ATOMIC_RELAXED));
+    fprintf(f, "\nnodes %lld\n", (long long)__atomic_load_n(&(p->nodes), __ATOMIC_RELAXED));
+
+    if ((fclose(f) != 0) || (rename(tmp, p->path) == -1))
+    {
+        unlink(tmp);
+        ret = -1;
+    }
+    free(tmp);
+    return ret;
+}
+
+/**
+ * @brief Thread di scrittura: un aggiornamento ogni PROGRESS_PERIOD_MS
+ */
+static void *writer(void *arg)
+{
+    SopProgress *p = arg;
+
+    pthread_mutex_lock(&(p->lock));
+    while (!p->stop)
+    {
+        /* un errore di scrittura non interrompe la sintesi, si riprova al periodo successivo */
+        writeProgress(p);
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += PROGRESS_PERIOD_MS / 1000;
+        deadline.tv_nsec += (PROGRESS_PERIOD_MS % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (!p->stop && (pthread_cond_timedwait(&(p->wake), &(p->lock), &deadline) != ETIMEDOUT))
+            ;
+    }
+    pthread_mutex_unlock(&(p->lock));
+
+    return NULL;
+}
+
+int progress_open(SopProgress *p)
+{
+    if ((p->path == NULL) || p->active)
+        return 0;
+
+    p->start = now(CLOCK_MONOTONIC);
+    p->phase = "start";
+    p->cubes_done = p->cubes_total = p->generated = 0;
+    p->queue_len = p->accepted = p->total_error = p->nodes = 0;
+    p->errors = NULL;
+    p->n_errors = p->first_output = 0;
+    p->stop = 0;
+
+    if (writeProgress(p) == -1)
+    {
+        fprintf(stderr, "[!!] impossibile scrivere il file di avanzamento %s: ", p->path);
+        perror(NULL);
+        return -1;
+    }
+
+    pthread_mutex_init(&(p->lock), NULL);
+    pthread_cond_init(&(p->wake), NULL);
+    if (pthread_create(&(p->writer), NULL, writer, p) != 0)
+    {
+        perror("[!!] pthread_create");
+        pthread_mutex_destroy(&(p->lock));
+        pthread_cond_destroy(&(p->wake));
+        return -1;
+    }
+    p->active = 1;
+
+    return 0;
+}
+
+void progress_outputs(SopProgress *p, int num_out)
+{
+    if (!p->active)
+        return;
+
+    pthread_mutex_lock(&(p->lock));
+    free(p->errors);
+    p->errors = safe_calloc(num_out, sizeof(int64_t));
+    p->n_errors = num_out;
+    p->first_output = 0;
+    pthread_mutex_unlock(&(p->lock));
+}
+
+void progress_close(SopProgress *p)
+{
+    if (!p->active)
+        return;
+
+    pthread_mutex_lock(&(p->lock));
+    p->stop = 1;
+    pthread_cond_signal(&(p->wake));
+    pthread_mutex_unlock(&(p->lock));
+    pthread_join(p->writer, NULL);
+
+    p->active = 0;
+    p->phase = "done";
+    if (writeProgress(p) == -1)
+        fprintf(stderr, "[!!] impossibile scrivere il file di avanzamento %s\n", p->path);
+
+    pthread_mutex_destroy(&(p->lock));
+    pthread_cond_destroy(&(p->wake));
+    free(p->errors);
+    p->errors = NULL;
+    p->n_errors = 0;
+}
@@ -0,0 +1,99 @@
+#ifndef _PROGRESS_H
+#define _PROGRESS_H
+
+/**
+ * @file progress.h
+ * @author Marco Costa
+ * @brief Stato di avanzamento di una sintesi, riscritto periodicamente su file da un
+ *  thread dedicato: la sintesi aggiorna solo dei contatori con store atomici rilassati
+ */
+
+#include <stdint.h>
+#include <pthread.h>
+
+/**
+ * @brief Periodo di aggiornamento del file [ms]
+ */
+#define PROGRESS_PERIOD_MS 1000
+
+/**
+ * @brief Contatori di avanzamento. I campi sono scritti dal thread della sintesi (o
+ *  dai thread di valutazione dei candidati) e letti dal thread di scrittura
+ */
+typedef struct SopProgress
+{
+    char *path;            /**< file di avanzamento, NULL se disattivato */
+    int active;            /**< se il thread di scrittura è in esecuzione */
+    pthread_t writer;      /**< thread di scrittura */
+    pthread_mutex_t lock;  /**< protegge errors, n_errors e stop */
+    pthread_cond_t wake;   /**< risveglio anticipato per la terminazione */
+    int stop;              /**< richiesta di terminazione del thread di scrittura */
+    double start;          /**< istante di attivazione [s] */
+
+    const char *phase;     /**< fase corrente */
+    int64_t cubes_done;    /**< prodotti espansi */
+    int64_t cubes_total;   /**< prodotti da espandere */
+    int64_t generated;     /**< candidati generati */
+    int64_t queue_len;     /**< candidati in coda */
+    int64_t accepted;      /**< prodotti accettati */
+    int64_t total_error;   /**< mintermini complementati */
+    int64_t nodes;         /**< nodi vivi del CUDD manager della sintesi */
+    int64_t *errors;       /**< mintermini complementati per output */
+    int n_errors;
+    int first_output;      /**< indice del primo output dell'estrazione, in streaming quello del gruppo */
+} SopProgress;
+
+/**
+ * @brief Avvio del thread di scrittura, se il file è impostato
+ *
+ * @param p i contatori
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int progress_open(SopProgress *p);
+
+/**
+ * @brief Azzeramento dell'errore per output all'inizio di un'estrazione. In streaming
+ *  viene chiamata una sola volta con tutti gli output, le estrazioni dei gruppi
+ *  impostano first_output
+ *
+ * @param p i contatori
+ * @param num_out il numero di output
+ */
+void progress_outputs(SopProgress *p, int num_out);
+
+/**
+ * @brief Ultima scrittura con fase "done" e terminazione del thread di scrittura
+ *
+ * @param p i contatori
+ */
+void progress_close(SopProgress *p);
+
+static inline void progress_phase(SopProgress *p, const char *phase)
+{
+    if (p->active)
+        __atomic_store_n(&(p->phase), phase, __ATOMIC_RELAXED);
+}
+
+static inline void progress_set(SopProgress *p, int64_t *field, int64_t value)
+{
+    if (p->active)
+        __atomic_store_n(field, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Incremento di un contatore condiviso tra i thread di valutazione
+ */
+static inline void progress_add(SopProgress *p, int64_t *field, int64_t n)
+{
+    if (p->active)
+        __atomic_fetch_add(field, n, __ATOMIC_RELAXED);
+}
+
+static inline void progress_error(SopProgress *p, int o, int64_t error)
+{
+    o += p->first_output;
+    if (p->active && (o < p->n_errors))
+        __atomic_store_n(&(p->errors[o]), error, __ATOMIC_RELAXED);
+}
+
+#endif
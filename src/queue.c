@@ -2,60 +2,218 @@
  * @file queue.c
  * @author Marco Costa
  * @brief Implementazione delle funzioni per l'utilizzo della coda di priorità
- * @version 0.1
+ * @version 0.2
  */
+#define _POSIX_C_SOURCE 200809L
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "queue.h"
+#include "utils.h"
 
-void push(prior_queue *h, double priority, product_t *data)
+/* posizioni libere in testa a prio: i figli 4i+1..4i+4 cadono su un multiplo di 4 */
+#define QUEUE_PAD (QUEUE_ARITY - 1)
+#define CACHE_LINE 64
+
+/**
+ * @brief Ordinamento degli elementi: priorità maggiore, a parità chiave minore
+ */
+static inline int before(double pa, uint32_t ka, double pb, uint32_t kb)
+{
+    return (pa > pb) || (pa == pb && ka < kb);
+}
+
+/**
+ * @brief Ridimensionamento dei vettori prio e key a capacità size
+ */
+static void resize(prior_queue *h, int size)
 {
-    /* reallocazione del vettore in mancanza di memoria */
-    if (h->len + 1 >= h->size)
+    void *mem;
+    size_t prio_bytes = (size + QUEUE_PAD) * sizeof(double);
+
+    /* prio e key nello stesso blocco allineato alla linea di cache */
+    prio_bytes = (prio_bytes + CACHE_LINE - 1) & ~((size_t)CACHE_LINE - 1);
+    if (posix_memalign(&mem, CACHE_LINE, prio_bytes + size * sizeof(uint32_t)) != 0)
     {
-        h->size = h->size ? h->size * 2 : INIT_SIZE;
-        h->nodes = (node_t *)realloc(h->nodes, h->size * sizeof(node_t));
+        fprintf(stderr, "Memoria esaurita\n");
+        exit(EXIT_FAILURE);
     }
 
-    int i = h->len + 1;
-    int j = i / 2;
+    double *prio = (double *)mem + QUEUE_PAD;
+    uint32_t *key = (uint32_t *)((char *)mem + prio_bytes);
 
-    while (i > 1 && h->nodes[j].priority < priority)
+    if (h->len > 0)
     {
-        h->nodes[i] = h->nodes[j];
-        i = j;
-        j = j / 2;
+        memcpy(prio, h->prio, h->len * sizeof(double));
+        memcpy(key, h->key, h->len * sizeof(uint32_t));
     }
-    h->nodes[i].priority = priority;
-    h->nodes[i].data = data;
-    h->len++;
+    free(h->mem);
+
+    h->mem = mem;
+    h->prio = prio;
+    h->key = key;
+    h->size = size;
 }
 
-product_t *pop(prior_queue *h)
+/**
+ * @brief Assegnazione di una chiave a data e accodamento in ultima posizione
+ */
+static int insertLast(prior_queue *h, double priority, product_t *data)
 {
-    int i, j, k;
+    if (h->len >= h->size)
+        resize(h, h->size ? h->size * 2 : INIT_SIZE);
 
-    product_t *data = h->nodes[1].data;
+    if (h->n_data >= h->data_size)
+    {
+        h->data_size = h->data_size ? h->data_size * 2 : h->size;
+        h->data = (product_t **)realloc(h->data, h->data_size * sizeof(product_t *));
+        if (h->data == NULL)
+        {
+            fprintf(stderr, "Memoria esaurita\n");
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    h->nodes[1] = h->nodes[h->len];
+    uint32_t k = h->n_data++;
+    h->data[k] = data;
+    h->prio[h->len] = priority;
+    h->key[h->len] = k;
+    return h->len++;
+}
 
-    h->len--;
+/**
+ * @brief Discesa dell'elemento (p, k) a partire dalla posizione vuota i
+ */
+static void siftDown(prior_queue *h, int i, double p, uint32_t k)
+{
+    double *prio = h->prio;
+    uint32_t *key = h->key;
+    int len = h->len;
 
-    i = 1;
-    while (i != h->len + 1)
+    for (;;)
     {
-        k = h->len + 1;
-        j = 2 * i;
-        if (j <= h->len && h->nodes[j].priority > h->nodes[k].priority)
-            k = j;
+        int first = QUEUE_ARITY * i + 1;
+        if (first >= len)
+            break;
+
+        int last = first + QUEUE_ARITY < len ? first + QUEUE_ARITY : len;
+        int best = first;
+        for (int c = first + 1; c < last; c++)
+            if (before(prio[c], key[c], prio[best], key[best]))
+                best = c;
+
+        if (!before(prio[best], key[best], p, k))
+            break;
+
+        prio[i] = prio[best];
+        key[i] = key[best];
+        i = best;
+    }
+    prio[i] = p;
+    key[i] = k;
+}
 
-        if (j + 1 <= h->len && h->nodes[j + 1].priority > h->nodes[k].priority)
-            k = j + 1;
+product_t *product_new(Arena *a, int num_in)
+{
+    size_t head = (sizeof(product_t) + sizeof(int) - 1) / sizeof(int) * sizeof(int);
+    product_t *p = arena_alloc(a, head + num_in * sizeof(int));
+
+    memset(p, 0, sizeof(product_t));
+    p->cube = (int *)((char *)p + head);
+    return p;
+}
+
+void product_add_origin(Arena *a, product_t *p, int origin)
+{
+    int n = p->n_origins;
 
-        h->nodes[i] = h->nodes[k];
-        i = k;
+    /* la capacità è raddoppiata quando n_origins è 0 o una potenza di 2: le origini
+       rimosse dall'invalidazione riducono n_origins, mai sotto la capacità necessaria */
+    if ((n & (n - 1)) == 0)
+    {
+        int *origins = arena_alloc(a, (n > 0 ? 2 * n : 1) * sizeof(int));
+        if (n > 0)
+            memcpy(origins, p->origins, n * sizeof(int));
+        p->origins = origins; /* il vettore precedente resta nell'arena fino al rilascio */
     }
+    p->origins[p->n_origins++] = origin;
+}
+
+void queue_init(prior_queue *h, int capacity)
+{
+    memset(h, 0, sizeof(prior_queue));
+    resize(h, capacity > 0 ? capacity : INIT_SIZE);
+    h->data_size = h->size;
+    h->data = safe_malloc(h->data_size * sizeof(product_t *));
+}
+
+/**
+ * @brief Risalita dell'elemento (priority, k) a partire dalla posizione vuota i
+ */
+static void siftUp(prior_queue *h, int i, double priority, uint32_t k)
+{
+    while (i > 0)
+    {
+        int j = (i - 1) / QUEUE_ARITY;
+        if (!before(priority, k, h->prio[j], h->key[j]))
+            break;
+
+        h->prio[i] = h->prio[j];
+        h->key[i] = h->key[j];
+        i = j;
+    }
+    h->prio[i] = priority;
+    h->key[i] = k;
+}
+
+void push(prior_queue *h, double priority, product_t *data)
+{
+    int i = insertLast(h, priority, data);
+    siftUp(h, i, priority, h->key[i]);
+}
+
+void reinsert(prior_queue *h, double priority)
+{
+    /* la posizione liberata da pop è ancora disponibile: len < size */
+    siftUp(h, h->len++, priority, h->popped);
+}
+
+void append(prior_queue *h, double priority, product_t *data)
+{
+    insertLast(h, priority, data);
+}
+
+void heapify(prior_queue *h)
+{
+    if (h->len < 2)
+        return;
+
+    /* discesa a partire dall'ultimo nodo interno (Floyd) */
+    for (int i = (h->len - 2) / QUEUE_ARITY; i >= 0; i--)
+        siftDown(h, i, h->prio[i], h->key[i]);
+}
+
+product_t *pop(prior_queue *h)
+{
+    if (h->len == 0)
+        return NULL;
+
+    product_t *data = h->data[h->key[0]];
+    h->popped = h->key[0];
+
+    /* l'ultimo elemento viene spostato in cima e fatto scendere */
+    h->len--;
+    if (h->len > 0)
+        siftDown(h, 0, h->prio[h->len], h->key[h->len]);
+
     return data;
-}
\ No newline at end of file
+}
+
+void queue_free(prior_queue *h)
+{
+    free(h->mem);
+    free(h->data);
+    memset(h, 0, sizeof(prior_queue));
+}
@@ -6,16 +6,28 @@
  * @author Marco Costa
  * @brief Include i prototipi e le strutture per la gestione della coda di
  *  priorità
- * @version 0.1
+ * @version 0.2
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #include <cudd.h>
 
+#include "arena.h"
+
 #define INIT_SIZE 20
 
+/* capacità iniziale massima di una coda dimensionata sui candidati previsti */
+#define QUEUE_PRESIZE_MAX (1 << 20)
+
+/**
+ * @brief Arietà dell'heap: i figli di un nodo occupano 4 double contigui,
+ *  allineati in modo da non attraversare mai due linee di cache
+ */
+#define QUEUE_ARITY 4
+
 /**
  * @brief Struttura rappresentante un singolo prodotto espanso
  */
@@ -26,38 +38,116 @@ typedef struct
     int covered_prod;   /* numero di prodotti coperti */
     double compl_min;   /* numero di mintermini complementati */
     int product_number; /* espansione di provenienza */
+    int *origins;       /* altre espansioni che generano lo stesso prodotto, in ordine crescente */
+    int n_origins;      /* numero di elementi di origins */
     int valid;          /* validità prodotto in coda */
+    int epoch;          /* prodotti accettati sull'output al calcolo di covered_prod */
     DdNode *offset_inters;
 } product_t;
 
-typedef struct
-{
-    double priority;
-    product_t *data;
-} node_t;
+/**
+ * @brief Allocazione di un prodotto espanso e del suo cubo in un unico blocco
+ *  dell'arena: i prodotti non vengono rilasciati singolarmente ma con l'arena
+ *
+ * @param a l'arena dei prodotti
+ * @param num_in il numero di var. di input
+ * @return product_t* il prodotto azzerato, con cube di num_in elementi
+ */
+product_t *product_new(Arena *a, int num_in);
+
+/**
+ * @brief Aggiunta di un'origine a un prodotto, dopo quelle già presenti
+ *
+ * @param a l'arena dei prodotti
+ * @param p il prodotto
+ * @param origin l'espansione di provenienza
+ */
+void product_add_origin(Arena *a, product_t *p, int origin);
 
+/**
+ * @brief Heap d-ario con priorità e chiavi memorizzate in vettori separati:
+ *  i confronti leggono solo prio e key, il prodotto viene letto solo all'estrazione.
+ *  A parità di priorità viene estratto il prodotto inserito per primo; un prodotto
+ *  reinserito conserva la posizione del suo primo inserimento
+ */
 typedef struct
 {
-    node_t *nodes;
-    int len;
-    int size;
+    double *prio;     /* priorità per posizione nell'heap */
+    uint32_t *key;    /* chiave compatta per posizione nell'heap: indice in data */
+    product_t **data; /* prodotti inseriti, indicizzati per chiave */
+    void *mem;        /* blocco allineato che contiene prio e key */
+    int len;          /* numero di elementi nell'heap */
+    int size;         /* capacità di prio e key */
+    int n_data;       /* numero di chiavi assegnate */
+    int data_size;    /* capacità di data */
+    uint32_t popped;  /* chiave dell'ultimo elemento estratto */
 } prior_queue;
 
+/**
+ * @brief Inizializzazione di una coda vuota con capacità iniziale capacity
+ *
+ * @param h la coda di priorità
+ * @param capacity il numero di elementi previsto
+ */
+void queue_init(prior_queue *h, int capacity);
+
 /**
  * @brief Inserimento di un elemento in coda con priorità "priority"
- * 
+ *
  * @param h la coda di priorità
  * @param priority la priorità
  * @param data l'elemento da inserire in coda
  */
 void push(prior_queue *h, double priority, product_t *data);
 
+/**
+ * @brief Reinserimento dell'ultimo prodotto estratto con pop, con priorità "priority":
+ *  il prodotto riusa la sua chiave, quindi data cresce con i prodotti generati e non
+ *  con le estrazioni. Va chiamata prima di ogni altro inserimento
+ *
+ * @param h la coda di priorità
+ * @param priority la nuova priorità
+ */
+void reinsert(prior_queue *h, double priority);
+
+/**
+ * @brief Inserimento di un elemento in coda senza ripristinare l'ordinamento:
+ *  dopo una serie di append la coda va riordinata con heapify
+ *
+ * @param h la coda di priorità
+ * @param priority la priorità
+ * @param data l'elemento da inserire in coda
+ */
+void append(prior_queue *h, double priority, product_t *data);
+
+/**
+ * @brief Costruzione dell'heap in O(n) a partire dagli elementi presenti
+ *
+ * @param h la coda di priorità
+ */
+void heapify(prior_queue *h);
+
 /**
  * @brief Estrazione del prodotto con priorità massima dalla coda jh
- * 
+ *
  * @param h la coda
- * @return product_t* il prodotto con priorità massima
+ * @return product_t* il prodotto con priorità massima, NULL se la coda è vuota
  */
 product_t *pop(prior_queue *h);
 
+/**
+ * @brief Prodotto in posizione i dell'heap, 0 <= i < len
+ */
+static inline product_t *queue_at(prior_queue *h, int i)
+{
+    return h->data[h->key[i]];
+}
+
+/**
+ * @brief Rilascio della memoria della coda (non dei prodotti)
+ *
+ * @param h la coda
+ */
+void queue_free(prior_queue *h);
+
 #endif
\ No newline at end of file
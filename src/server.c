@@ -0,0 +1,362 @@
+/**
+ * @file server.c
+ * @author Marco Costa
+ * @brief Implementazione della modalità server: il processo principale legge i job
+ *  da stdin e li distribuisce ad un pool di worker. Ogni worker esegue un job alla
+ *  volta nel proprio workspace, con un CUDD manager riutilizzato tra i job
+ */
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/select.h>
+#include <sys/resource.h>
+
+#include <cudd.h>
+
+#include "server.h"
+#include "libsop.h"
+#include "config.h"
+#include "utils.h"
+
+/**
+ * @brief Stato di un worker visto dal processo principale
+ */
+typedef struct Worker
+{
+    pid_t pid;
+    FILE *job;    /**< richieste verso il worker */
+    FILE *res;    /**< risposte dal worker */
+    char *job_id; /**< id del job in esecuzione, NULL se il worker è libero */
+} Worker;
+
+/**
+ * @brief Esecuzione di un singolo job e scrittura della risposta
+ *
+ * @param ctx il contesto del worker
+ * @param line la richiesta
+ * @param out il canale delle risposte
+ */
+static void runJob(SopContext *ctx, char *line, FILE *out)
+{
+    char *id = NULL, *mode = NULL, *error = NULL, *file = NULL;
+
+    if ((sscanf(line, "%ms %ms %ms %m[^\n]", &id, &mode, &error, &file) != 4) ||
+        ((strcmp(mode, "g") != 0) && (strcmp(mode, "m") != 0)))
+        fprintf(out, "%s; ERROR; richiesta non valida\n", (id != NULL) ? id : "?");
+    else if (sop_set_error(ctx, (mode[0] == 'g') ? GLOBAL_OUTPUT_ERROR : MULTIPLE_OUTPUT_ERROR, error) == -1)
+        fprintf(out, "%s; ERROR; errore non valido\n", id);
+    else if ((access(file, R_OK) == -1) || (sop_parse(ctx, file) == -1))
+        fprintf(out, "%s; ERROR; impossibile leggere %s\n", id, file);
+    else if (sop_heuristic(ctx) == -1)
+        fprintf(out, "%s; ERROR; sintesi di %s fallita\n", id, file);
+    else
+    {
+        fprintf(out, "%s; ", id);
+        sop_print_csv(ctx, file, out);
+    }
+    fflush(out);
+
+    free(id);
+    free(mode);
+    free(error);
+    free(file);
+}
+
+/**
+ * @brief Ciclo principale di un worker, termina alla chiusura della pipe dei job
+ *
+ * @param options il contesto con le opzioni del motore
+ * @param k l'indice del worker
+ * @param job_fd la pipe delle richieste
+ * @param res_fd la pipe delle risposte
+ * @param mem_limit limite di memoria per job (0 = illimitato)
+ * @param output_root la directory di output del server
+ */
+static void workerMain(const SopContext *options, int k, int job_fd, int res_fd, size_t mem_limit,
+                       const char *output_root)
+{
+    SopContext ctx;
+    FILE *in = fdopen(job_fd, "r");
+    FILE *out = fdopen(res_fd, "w");
+    char *output_dir, *line = NULL;
+    size_t n = 0;
+
+    /* i messaggi del motore e di espresso non devono finire tra le risposte */
+    int devnull = open("/dev/null", O_RDWR);
+    dup2(devnull, STDIN_FILENO);
+    dup2(devnull, STDOUT_FILENO);
+    close(devnull);
+
+    /* il worker esegue un job alla volta: il limite del processo è il limite del job */
+    if (mem_limit > 0)
+    {
+        struct rlimit rl = {.rlim_cur = mem_limit, .rlim_max = mem_limit};
+        setrlimit(RLIMIT_AS, &rl);
+    }
+
+    sop_init(&ctx);
+    sop_copy_options(&ctx, options);
+    ctx.output_mode = TEST_LOG;
+    /* file temporanei riservati e output nella directory del server: più server
+       possono girare sulla stessa macchina, anche nella stessa directory */
+    asprintf(&output_dir, "%sworker-%d/", output_root, k);
+    if (sop_private_workspace(&ctx, output_dir) == -1)
+        exit(EXIT_FAILURE);
+
+    while (getline(&line, &n, in) != -1)
+    {
+        if (ctx.manager == NULL)
+            ctx.manager = Cudd_Init(0, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, mem_limit);
+
+        runJob(&ctx, line, out);
+        sop_reset(&ctx);
+
+        /* il manager viene ricreato solo se è cresciuto oltre metà del limite */
+        if ((mem_limit > 0) && (Cudd_ReadMemoryInUse(ctx.manager) > mem_limit / 2))
+        {
+            Cudd_Quit(ctx.manager);
+            ctx.manager = NULL;
+        }
+    }
+
+    sop_free(&ctx);
+    free(line);
+    free(output_dir);
+    fclose(in);
+    fclose(out);
+
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Creazione del k-esimo worker
+ *
+ * @param options il contesto con le opzioni del motore
+ * @param all tutti i worker
+ * @param n numero di worker
+ * @param k indice del worker da creare
+ * @param mem_limit limite di memoria per job
+ * @param output_root la directory di output del server
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+static int spawnWorker(const SopContext *options, Worker *all, int n, int k, size_t mem_limit,
+                       const char *output_root)
+{
+    int job[2], res[2];
+
+    if (pipe(job) == -1)
+        return -1;
+    if (pipe(res) == -1)
+    {
+        close(job[0]);
+        close(job[1]);
+        return -1;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == -1)
+    {
+        perror("[!!] impossibile creare il worker");
+        close(job[0]);
+        close(job[1]);
+        close(res[0]);
+        close(res[1]);
+        return -1;
+    }
+
+    if (pid == 0)
+    {
+        /* le pipe degli altri worker vanno chiuse, altrimenti non riceverebbero mai EOF */
+        for (int i = 0; i < n; i++)
+        {
+            if (all[i].job != NULL)
+                fclose(all[i].job);
+            if (all[i].res != NULL)
+                fclose(all[i].res);
+        }
+        close(job[1]);
+        close(res[0]);
+        workerMain(options, k, job[0], res[1], mem_limit, output_root);
+    }
+
+    close(job[0]);
+    close(res[1]);
+    all[k].pid = pid;
+    all[k].job = fdopen(job[1], "w");
+    all[k].res = fdopen(res[0], "r");
+    all[k].job_id = NULL;
+
+    return 0;
+}
+
+/**
+ * @brief Chiusura delle pipe di un worker e attesa della sua terminazione
+ *
+ * @param w il worker
+ */
+static void reapWorker(Worker *w)
+{
+    fclose(w->job);
+    fclose(w->res);
+    waitpid(w->pid, NULL, 0);
+    w->job = w->res = NULL;
+}
+
+/**
+ * @brief Creazione della directory di output riservata al server, in OUTPUT_DIR
+ *
+ * @return char* la directory, terminata da '/', NULL in caso di errore
+ */
+static char *privateOutputRoot(void)
+{
+    char *templ, *root;
+
+    if ((mkdir(OUTPUT_DIR, 0755) == -1) && (errno != EEXIST))
+    {
+        fprintf(stderr, "[!!] impossibile creare la cartella %s: ", OUTPUT_DIR);
+        perror("");
+        return NULL;
+    }
+
+    asprintf(&templ, "%sserver-XXXXXX", OUTPUT_DIR);
+    if (mkdtemp(templ) == NULL)
+    {
+        fprintf(stderr, "[!!] impossibile creare una cartella di output in %s: ", OUTPUT_DIR);
+        perror("");
+        free(templ);
+        return NULL;
+    }
+
+    asprintf(&root, "%s/", templ);
+    free(templ);
+    return root;
+}
+
+int sop_serve(const SopContext *options, int workers, size_t mem_limit, const char *output_dir)
+{
+    Worker *w = safe_calloc(workers, sizeof(Worker));
+    char *line = NULL;
+    size_t n = 0;
+    int eof = 0, busy = 0, ret = 0;
+
+    /* senza directory esplicita, una directory nuova per ogni server */
+    char *root = (output_dir != NULL) ? strdup(output_dir) : privateOutputRoot();
+    if (root == NULL)
+        exit(EXIT_FAILURE);
+    fprintf(stderr, "Output dei worker in %s\n", root);
+
+    /* un worker terminato non deve terminare il server */
+    signal(SIGPIPE, SIG_IGN);
+    /* nessun buffering: select deve vedere tutte le richieste non ancora lette */
+    setvbuf(stdin, NULL, _IONBF, 0);
+
+    for (int k = 0; k < workers; k++)
+    {
+        if (spawnWorker(options, w, workers, k, mem_limit, root) == -1)
+        {
+            fprintf(stderr, "[!!] impossibile avviare i worker\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    while (!eof || (busy > 0))
+    {
+        fd_set rfds;
+        int maxfd = -1;
+
+        FD_ZERO(&rfds);
+        if (!eof && (busy < workers))
+        {
+            FD_SET(STDIN_FILENO, &rfds);
+            maxfd = STDIN_FILENO;
+        }
+        for (int k = 0; k < workers; k++)
+        {
+            if (w[k].job_id == NULL)
+                continue;
+            FD_SET(fileno(w[k].res), &rfds);
+            if (fileno(w[k].res) > maxfd)
+                maxfd = fileno(w[k].res);
+        }
+
+        if (select(maxfd + 1, &rfds, NULL, NULL, NULL) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("[!!] select");
+            exit(EXIT_FAILURE);
+        }
+
+        /* risposte dei worker */
+        for (int k = 0; k < workers; k++)
+        {
+            if ((w[k].job_id == NULL) || !FD_ISSET(fileno(w[k].res), &rfds))
+                continue;
+
+            if (getline(&line, &n, w[k].res) != -1)
+                fputs(line, stdout);
+            else
+            {
+                /* il worker è terminato durante il job (es. limite di memoria) */
+                printf("%s; ERROR; worker terminato durante il job\n", w[k].job_id);
+                reapWorker(&w[k]);
+                if (spawnWorker(options, w, workers, k, mem_limit, root) == -1)
+                {
+                    fprintf(stderr, "[!!] impossibile riavviare il worker %d\n", k);
+                    exit(EXIT_FAILURE);
+                }
+                ret = -1;
+            }
+            fflush(stdout);
+
+            free(w[k].job_id);
+            w[k].job_id = NULL;
+            busy--;
+        }
+
+        /* nuove richieste */
+        if ((maxfd >= 0) && FD_ISSET(STDIN_FILENO, &rfds) && !eof && (busy < workers))
+        {
+            char *id = NULL;
+
+            if (getline(&line, &n, stdin) == -1)
+            {
+                eof = 1;
+                continue;
+            }
+            if (sscanf(line, "%ms", &id) != 1)
+                continue; /* riga vuota */
+
+            int k = 0;
+            while (w[k].job_id != NULL)
+                k++;
+
+            w[k].job_id = id;
+            fputs(line, w[k].job);
+            if (line[strlen(line) - 1] != '\n')
+                fputc('\n', w[k].job);
+            fflush(w[k].job);
+            busy++;
+        }
+    }
+
+    for (int k = 0; k < workers; k++)
+        reapWorker(&w[k]);
+
+    free(line);
+    free(w);
+    free(root);
+
+    return ret;
+}
@@ -0,0 +1,32 @@
+#ifndef _SERVER_H
+#define _SERVER_H
+
+/**
+ * @file server.h
+ * @author Marco Costa
+ * @brief Modalità server: esecuzione di job letti da stdin, una riga per job,
+ *  mediante un pool di processi worker che riutilizzano il proprio CUDD manager
+ *
+ * Formato di una richiesta:   id g|m errore file.pla
+ * Formato di una risposta:    id; <riga CSV di -t>
+ *                             id; ERROR; motivo
+ */
+
+#include <stddef.h>
+
+#include "libsop.h"
+
+/**
+ * @brief Avvia il server e termina alla chiusura di stdin, dopo aver completato
+ *  tutti i job ricevuti
+ *
+ * @param options il contesto da cui i worker copiano le opzioni del motore (sop_copy_options)
+ * @param workers il numero massimo di job eseguiti in parallelo
+ * @param mem_limit limite di memoria per job in byte (0 = illimitato)
+ * @param output_dir directory in cui ogni worker crea la sua worker-N/ (terminata da '/'),
+ *  NULL per una directory riservata al server creata con mkdtemp in OUTPUT_DIR
+ * @return int 0 se tutti i job sono stati completati, -1 altrimenti
+ */
+int sop_serve(const SopContext *options, int workers, size_t mem_limit, const char *output_dir);
+
+#endif
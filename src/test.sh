@@ -1,8 +1,8 @@
 #!/bin/bash
-FILE_DIR=./pla/*.pla
+PLA_DIR=./pla
 USAGE="usage: $0 [g-m] [ERROR] [OUTPUT-FILE]"
 
-if [ $# -ne 3 ] 
+if [ $# -ne 3 ]
 then
     echo "numero errato di argomenti"
     echo "$USAGE"
@@ -15,25 +15,35 @@ then
     exit -1
 fi
 
-echo "NomeFile; Ct; r [%]; oldAND ;oldOR ;newAND ;newOR ;percAND [%] ;percOR [%]; CPUtime [s]" > "$3"
-
-if [ $? -ne 0 ]
+if ! : > "$3"
 then
    echo "impossibile scrivere sul file $3".
    exit -1
 fi
 
-for file in $FILE_DIR; do
-    ./main "-t" "-$1" "$2" "$file" >> "$3"
-    if [ $? -ne 0 ]; then
-        echo "errore con il test $file".
-    else
-		out=$(basename "$file")
-		mv "./out/best.pla" "./temp/$out"
-	fi
-    sleep 0.1
+# ogni file gira in un proprio processo con la propria directory di output
+mkdir -p ./temp
+RESULTS=$(mktemp -d ./temp/results-XXXXXX)
+if [ $? -ne 0 ]
+then
+    echo "impossibile creare la cartella dei risultati"
+    exit -1
+fi
+
+./batch -j "$(nproc)" -o "$RESULTS" "$PLA_DIR" "$1" "$2" > "$3"
+if [ $? -ne 0 ]; then
+    echo "errore con alcuni test, vedi le righe ERROR e TIMEOUT in $3"
+fi
+
+for file in $PLA_DIR/*.pla; do
+    out=$(basename "$file")
+    best="$RESULTS/${out%.pla}-$1$2/best.pla"
+    if [ -f "$best" ]; then
+        mv "$best" "./temp/$out"
+    fi
 done
+rm -rf "$RESULTS"
 
 unix2dos "$3"
 
-exit 0
\ No newline at end of file
+exit 0
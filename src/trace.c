@@ -0,0 +1,114 @@
+/**
+ * @file trace.c
+ * @author Marco Costa
+ * @brief Implementazione della traccia binaria dell'estrazione greedy
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+
+#include "trace.h"
+#include "utils.h"
+
+/* pausa del consumatore quando il ring buffer è vuoto */
+#define TRACE_POLL_NS 1000000L
+
+/**
+ * @brief Scrittura su file dei record in [tail, head)
+ */
+static void drain(SopTrace *t, uint64_t head)
+{
+    while (t->tail < head)
+    {
+        uint64_t first = t->tail & (TRACE_RING_SIZE - 1);
+        uint64_t n = head - t->tail;
+
+        /* un solo fwrite per tratto contiguo del ring */
+        if (first + n > TRACE_RING_SIZE)
+            n = TRACE_RING_SIZE - first;
+        fwrite(&(t->ring[first]), sizeof(SopTraceRecord), n, t->f);
+        __atomic_store_n(&(t->tail), t->tail + n, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Thread di scrittura
+ */
+static void *writer(void *arg)
+{
+    SopTrace *t = arg;
+    struct timespec pause = {0, TRACE_POLL_NS};
+
+    for (;;)
+    {
+        uint64_t head = __atomic_load_n(&(t->head), __ATOMIC_ACQUIRE);
+
+        if (head != t->tail)
+            drain(t, head);
+        else if (__atomic_load_n(&(t->stop), __ATOMIC_ACQUIRE))
+            break;
+        else
+            nanosleep(&pause, NULL);
+    }
+
+    return NULL;
+}
+
+int trace_open(SopTrace *t, SopTraceHeader *h)
+{
+    t->f = fopen(t->path, "wb");
+    if (t->f == NULL)
+    {
+        perror("[!!] impossibile aprire il file di traccia");
+        return -1;
+    }
+
+    memcpy(h->magic, TRACE_MAGIC, sizeof(h->magic));
+    h->version = TRACE_VERSION;
+    h->record_size = sizeof(SopTraceRecord);
+    fwrite(h, sizeof(SopTraceHeader), 1, t->f);
+
+    t->ring = safe_malloc(TRACE_RING_SIZE * sizeof(SopTraceRecord));
+    t->head = t->tail = 0;
+    t->stop = 0;
+    t->seq = 0;
+
+    if (pthread_create(&(t->writer), NULL, writer, t) != 0)
+    {
+        perror("[!!] pthread_create");
+        fclose(t->f);
+        free(t->ring);
+        t->f = NULL;
+        t->ring = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+void trace_wait(SopTrace *t)
+{
+    while (t->head - __atomic_load_n(&(t->tail), __ATOMIC_ACQUIRE) >= TRACE_RING_SIZE)
+        sched_yield();
+}
+
+void trace_close(SopTrace *t)
+{
+    if (t->f == NULL)
+        return;
+
+    /* il consumatore termina dopo aver svuotato il ring */
+    __atomic_store_n(&(t->stop), 1, __ATOMIC_RELEASE);
+    pthread_join(t->writer, NULL);
+    drain(t, t->head);
+
+    if (fclose(t->f) != 0)
+        perror("[!!] impossibile scrivere il file di traccia");
+    free(t->ring);
+    t->f = NULL;
+    t->ring = NULL;
+}
@@ -0,0 +1,132 @@
+#ifndef _TRACE_H
+#define _TRACE_H
+
+/**
+ * @file trace.h
+ * @author Marco Costa
+ * @brief Traccia binaria delle decisioni dell'estrazione greedy: i record vengono
+ *  scritti in un ring buffer senza lock e un thread dedicato li riversa su file
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define TRACE_MAGIC "SOPTRACE"
+#define TRACE_VERSION 1
+
+/**
+ * @brief Numero di record del ring buffer, potenza di 2
+ */
+#define TRACE_RING_SIZE (1 << 16)
+
+/**
+ * @brief Eventi registrati nella traccia
+ */
+typedef enum
+{
+    TRACE_POP,         /**< estrazione dalla coda, value = priorità */
+    TRACE_INVALID,     /**< prodotto invalidato o già presente nella lista */
+    TRACE_RESCORE,     /**< priorità ricalcolata e prodotto rimesso in coda, value = nuova priorità */
+    TRACE_OVER_BUDGET, /**< errore ammesso superato, value = mintermini complementati effettivi */
+    TRACE_ACCEPT,      /**< prodotto accettato, a = candidati invalidati, b = prodotti rimossi,
+                            value = mintermini complementati effettivi */
+    TRACE_STOP,        /**< errore globale esaurito, a = candidati rimasti in coda */
+    N_TRACE_EVENTS
+} SopTraceEvent;
+
+/**
+ * @brief Intestazione del file di traccia
+ */
+typedef struct SopTraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t num_in;
+    uint32_t num_out;
+    uint32_t error_mode;
+    uint32_t lazy;
+    uint64_t ct;
+} SopTraceHeader;
+
+/**
+ * @brief Record della traccia, 24 byte
+ */
+typedef struct SopTraceRecord
+{
+    uint32_t seq;     /**< numero dell'estrazione dalla coda */
+    uint16_t event;   /**< SopTraceEvent */
+    uint16_t output;  /**< output del prodotto */
+    uint32_t product; /**< prodotto di provenienza */
+    uint32_t a;
+    uint32_t b;
+    float value;
+} SopTraceRecord;
+
+/**
+ * @brief Traccia di un contesto. Un solo produttore (l'estrazione) e un solo
+ *  consumatore (il thread di scrittura): head e tail sono contatori monotoni
+ */
+typedef struct SopTrace
+{
+    char *path;             /**< file della traccia, NULL se disattivata */
+    FILE *f;                /**< file aperto durante l'estrazione */
+    SopTraceRecord *ring;   /**< ring buffer */
+    uint64_t head;          /**< record prodotti, scritto solo dal produttore */
+    uint64_t tail;          /**< record scritti su file, scritto solo dal consumatore */
+    int stop;               /**< richiesta di terminazione del consumatore */
+    pthread_t writer;       /**< thread di scrittura */
+    uint32_t seq;           /**< estrazioni registrate */
+} SopTrace;
+
+/**
+ * @brief Apertura del file di traccia e avvio del thread di scrittura
+ *
+ * @param t la traccia, con path impostato
+ * @param h l'intestazione (magic, version e record_size vengono impostati qui)
+ * @return int -1 in caso di errore, 0 altrimenti
+ */
+int trace_open(SopTrace *t, SopTraceHeader *h);
+
+/**
+ * @brief Scrittura dei record rimanenti, terminazione del thread e chiusura del file
+ *
+ * @param t la traccia
+ */
+void trace_close(SopTrace *t);
+
+/**
+ * @brief Attesa di spazio nel ring buffer pieno
+ */
+void trace_wait(SopTrace *t);
+
+/**
+ * @brief Registrazione di un evento, senza effetto se la traccia non è aperta
+ */
+static inline void trace_emit(SopTrace *t, SopTraceEvent event, int output, int product, uint32_t a, uint32_t b,
+                              double value)
+{
+    if (t->f == NULL)
+        return;
+
+    uint64_t head = t->head;
+    if (head - __atomic_load_n(&(t->tail), __ATOMIC_ACQUIRE) >= TRACE_RING_SIZE)
+        trace_wait(t);
+
+    SopTraceRecord *r = &(t->ring[head & (TRACE_RING_SIZE - 1)]);
+    if (event == TRACE_POP)
+        t->seq++;
+    r->seq = t->seq;
+    r->event = event;
+    r->output = output;
+    r->product = product;
+    r->a = a;
+    r->b = b;
+    r->value = value;
+
+    /* il record è visibile al consumatore solo dopo l'avanzamento di head */
+    __atomic_store_n(&(t->head), head + 1, __ATOMIC_RELEASE);
+}
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file tracedump.c
+ * @author Marco Costa
+ * @brief Decodifica di una traccia binaria dell'estrazione greedy: stampa i record
+ *  in formato testuale e, con -s, solo il riepilogo per output
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "trace.h"
+#include "utils.h"
+
+static const char *event_names[N_TRACE_EVENTS] = {"pop", "invalid", "rescore", "over-budget", "accept", "stop"};
+
+/**
+ * @brief Contatori di un output
+ */
+typedef struct OutputSummary
+{
+    unsigned long events[N_TRACE_EVENTS];
+    unsigned long invalidated;
+    unsigned long removed;
+    double error;
+} OutputSummary;
+
+/**
+ * @brief Stampa di un record
+ */
+static void printRecord(SopTraceRecord *r)
+{
+    const char *name = (r->event < N_TRACE_EVENTS) ? event_names[r->event] : "?";
+
+    printf("%u %s out=%u prod=%u", r->seq, name, r->output, r->product);
+    if (r->event == TRACE_ACCEPT)
+        printf(" invalidated=%u removed=%u error=%g", r->a, r->b, r->value);
+    else if (r->event == TRACE_OVER_BUDGET)
+        printf(" error=%g", r->value);
+    else if (r->event == TRACE_STOP)
+        printf(" left=%u", r->a);
+    else if ((r->event == TRACE_POP) || (r->event == TRACE_RESCORE))
+        printf(" priority=%g", r->value);
+    printf("\n");
+}
+
+/**
+ * @brief Stampa del riepilogo per output
+ */
+static void printSummary(SopTraceHeader *h, OutputSummary *s)
+{
+    printf("output; pop; invalid; rescore; over-budget; accept; invalidated; removed; error\n");
+    for (uint32_t o = 0; o < h->num_out; o++)
+        printf("%u; %lu; %lu; %lu; %lu; %lu; %lu; %lu; %g\n", o, s[o].events[TRACE_POP], s[o].events[TRACE_INVALID],
+               s[o].events[TRACE_RESCORE], s[o].events[TRACE_OVER_BUDGET], s[o].events[TRACE_ACCEPT],
+               s[o].invalidated, s[o].removed, s[o].error);
+}
+
+int main(int argc, char *argv[])
+{
+    int opt, summary = 0;
+
+    while ((opt = getopt(argc, argv, "s")) != -1)
+    {
+        if (opt == 's')
+            summary = 1;
+        else
+        {
+            fprintf(stderr, "%s [-s] trace-file\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (optind != argc - 1)
+    {
+        fprintf(stderr, "%s [-s] trace-file\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    FILE *f = fopen(argv[optind], "rb");
+    if (f == NULL)
+    {
+        perror("[!!] impossibile aprire il file di traccia");
+        exit(EXIT_FAILURE);
+    }
+
+    SopTraceHeader h;
+    if ((fread(&h, sizeof(h), 1, f) != 1) || (memcmp(h.magic, TRACE_MAGIC, sizeof(h.magic)) != 0) ||
+        (h.version != TRACE_VERSION) || (h.record_size != sizeof(SopTraceRecord)))
+    {
+        fprintf(stderr, "[!!] %s non è una traccia valida\n", argv[optind]);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("# in=%u out=%u error=%s ct=%llu lazy=%u\n", h.num_in, h.num_out, h.error_mode ? "multiple" : "global",
+           (unsigned long long)h.ct, h.lazy);
+
+    OutputSummary *s = safe_calloc(h.num_out, sizeof(OutputSummary));
+    SopTraceRecord buf[1024];
+    size_t n;
+
+    while ((n = fread(buf, sizeof(SopTraceRecord), 1024, f)) > 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            SopTraceRecord *r = &(buf[i]);
+
+            if (!summary)
+                printRecord(r);
+            if ((r->output >= h.num_out) || (r->event >= N_TRACE_EVENTS))
+                continue;
+
+            s[r->output].events[r->event]++;
+            if (r->event == TRACE_ACCEPT)
+            {
+                s[r->output].invalidated += r->a;
+                s[r->output].removed += r->b;
+                s[r->output].error += r->value;
+            }
+        }
+    }
+
+    if (summary)
+        printSummary(&h, s);
+
+    free(s);
+    fclose(f);
+    return EXIT_SUCCESS;
+}
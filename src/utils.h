@@ -21,6 +21,11 @@
        __typeof__ (b) _b = (b); \
      _a < _b ? _a : _b; })
 
+#define max(a, b) \
+    ({ __typeof__ (a) _a = (a); \
+       __typeof__ (b) _b = (b); \
+     _a > _b ? _a : _b; })
+
 #define check_strtol(res, str, endptr)                           \
     if (endptr == str)                                           \
     {                                                            \
@@ -55,4 +60,15 @@ static inline void *safe_calloc(size_t nmemb, size_t nsize)
     return p;
 }
 
+static inline void *safe_realloc(void *ptr, size_t n)
+{
+    void *p = realloc(ptr, n);
+    if (!p && n > 0)
+    {
+        fprintf(stderr, "Impossibile allocare la memoria\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
 #endif
\ No newline at end of file